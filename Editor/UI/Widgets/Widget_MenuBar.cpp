@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Widget_MenuBar.h"
 #include "../FileDialog.h"
 #include "Core/Settings.h"
+#include "IO/PackFile.h"
 //=========================
 
 //= NAMESPACES ==========
@@ -85,6 +86,23 @@ void Widget_MenuBar::Tick(float deltaTime)
 			ImGui::EndMenu();
 		}
 
+		if (ImGui::BeginMenu("Project"))
+		{
+			// Everything a shipped build needs, in a single file (the engine mounts it when it's in the working directory)
+			if (ImGui::MenuItem("Pack"))
+			{
+				auto threading = m_context->GetSubsystem<Threading>();
+				auto directory = m_context->GetSubsystem<ResourceCache>()->GetProjectDirectory();
+				threading->AddTask([threading, directory]()
+				{
+					FileSystem::CreateDirectory_("Build/");
+					PackFile::Create(directory, string("Build/") + PACK_FILE_NAME, threading.get());
+				});
+			}
+
+			ImGui::EndMenu();
+		}
+
 		if (ImGui::BeginMenu("View"))
 		{
 			ImGui::MenuItem("ImGui Metrics",	nullptr, &_Widget_MenuBar::imgui_metrics);
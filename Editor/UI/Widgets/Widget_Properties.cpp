@@ -93,7 +93,10 @@ namespace ComponentProperty
 			{
 				if (g_copied && g_copied->GetType() == component->GetType())
 				{
-					component->SetAttributes(g_copied->GetAttributes());
+					component->CopyAttributes(g_copied.get());
+
+					// Attributes like casting shadows decide the entity's tags
+					component->GetEntity_PtrRaw()->TagsUpdate();
 				}
 			}
 
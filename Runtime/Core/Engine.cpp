@@ -32,6 +32,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Scripting/Scripting.h"
 #include "../Threading/Threading.h"
 #include "../World/World.h"
+#include "../IO/PackFile.h"
 //====================================
 
 //= NAMESPACES =====
@@ -54,6 +55,12 @@ namespace Directus
 		FileSystem::Initialize();
 		Settings::Get().Initialize();
 
+		// Shipped builds read their assets out of a pack
+		if (FileSystem::FileExists(PACK_FILE_NAME))
+		{
+			PackFile::Mount(PACK_FILE_NAME);
+		}
+
 		// Register subsystems
 		m_context->RegisterSubsystem<Timer>();
 		m_context->RegisterSubsystem<Profiler>();
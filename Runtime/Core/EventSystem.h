@@ -48,9 +48,11 @@ enum Event_Type
 	Event_World_Loaded,			// The world finished loading from file
 	Event_World_Unload,			// The world should clear everything
 	Event_World_Resolve,		// The world should resolve
-	Event_World_Submit,			// The world is submitting entities to the renderer
+	Event_World_EntityChanged,	// An entity's components have changed (data: the entity)
+	Event_World_EntityRemoved,	// An entity was removed from the world (data: the entity)
 	Event_World_Stop,			// The world should stop ticking
-	Event_World_Start			// The world should start ticking
+	Event_World_Start,			// The world should start ticking
+	Event_Material_Transparency	// A material switched between opaque and transparent
 };
 
 //= MACROS =====================================================================================================
@@ -87,6 +87,8 @@ namespace Directus
 		unsigned int GpuGetMemory() const					{ return m_gpu_memory; }
 		void SetGpuMemory(unsigned int memory)				{ m_gpu_memory = memory;}
 		bool GetReverseZ() const							{ return m_reverseZ; }
+		void SetAssetCompression(bool compress)				{ m_assetCompression = compress; }
+		bool GetAssetCompression() const					{ return m_assetCompression; }
 		//========================================================================================
 
 		// Third party lib versions
@@ -114,6 +116,7 @@ namespace Directus
 		float m_fpsTarget					= 165.0f;
 		FPS_Policy m_fpsPolicy				= FPS_MonitorMatch;
 		bool m_reverseZ						= true;
+		bool m_assetCompression				= true; // models and textures are saved block compressed
 		std::string m_gpu_name				= "Unknown";
 		unsigned int m_gpu_memory			= 0;
 	};
@@ -23,7 +23,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "FileSystem.h"
 #include <filesystem>
 #include <regex>
+#include <mutex>
+#include <unordered_map>
 #include "../Logging/Log.h"
+#include "../IO/PackFile.h"
 #include <Windows.h>
 #include <shellapi.h>
 //=========================
@@ -42,6 +45,71 @@ namespace Directus
 	vector<string> FileSystem::m_supportedScriptFormats;
 	vector<string> FileSystem::m_supportedFontFormats;
 
+	namespace
+	{
+		// Extensions (lower case) to file types, views into the supported formats, filled once by Initialize()
+		unordered_map<string_view, File_Type> g_file_types;
+		const size_t g_extension_length_max = 16;
+
+		// Directory listings (names only), by absolute directory. A listing is valid for as long as the directory's
+		// write time doesn't change, which it does whenever something is added, removed or renamed in it.
+		struct directory_listing
+		{
+			file_time_type write_time;
+			vector<string> files;
+			vector<string> directories;
+		};
+		unordered_map<string, directory_listing> g_directories;
+		mutex g_directories_mutex;
+
+		string directory_key(const string& directory)
+		{
+			error_code error;
+			auto key = absolute(directory, error).lexically_normal().generic_string();
+			if (key.size() > 1 && key.back() == '/')
+			{
+				key.pop_back();
+			}
+			return key;
+		}
+
+		directory_listing list_directory(const string& directory)
+		{
+			const auto key = directory_key(directory);
+
+			error_code error;
+			const auto write_time = last_write_time(key, error);
+			if (error)
+				return directory_listing();
+
+			{
+				lock_guard<mutex> lock(g_directories_mutex);
+				const auto it = g_directories.find(key);
+				if (it != g_directories.end() && it->second.write_time == write_time)
+					return it->second;
+			}
+
+			directory_listing listing;
+			listing.write_time = write_time;
+			for (auto it = directory_iterator(key, error); !error && it != directory_iterator(); it.increment(error))
+			{
+				error_code entry_error;
+				if (it->is_directory(entry_error))
+				{
+					listing.directories.emplace_back(it->path().filename().generic_string());
+				}
+				else if (it->is_regular_file(entry_error))
+				{
+					listing.files.emplace_back(it->path().filename().generic_string());
+				}
+			}
+
+			lock_guard<mutex> lock(g_directories_mutex);
+			g_directories[key] = listing;
+			return listing;
+		}
+	}
+
 	void FileSystem::Initialize()
 	{
 		// Supported image formats
@@ -171,6 +239,30 @@ namespace Directus
 			".bdf",
 			".pfr"
 		};
+
+		// File types, the supported formats above aren't modified past this point so they can be viewed
+		g_file_types.clear();
+		auto add = [](const vector<string>& extensions, const File_Type type)
+		{
+			for (const auto& extension : extensions)
+			{
+				g_file_types.emplace(extension, type);
+			}
+		};
+		add(m_supportedImageFormats,	File_Image);
+		add(m_supportedAudioFormats,	File_Audio);
+		add(m_supportedModelFormats,	File_Model);
+		add(m_supportedShaderFormats,	File_Shader);
+		add(m_supportedScriptFormats,	File_Script);
+		add(m_supportedFontFormats,		File_Font);
+		g_file_types[EXTENSION_PREFAB]		= File_Engine_Prefab;
+		g_file_types[EXTENSION_MODEL]		= File_Engine_Model;
+		g_file_types[EXTENSION_MATERIAL]	= File_Engine_Material;
+		g_file_types[EXTENSION_MESH]		= File_Engine_Mesh;
+		g_file_types[EXTENSION_WORLD]		= File_Engine_World;
+		g_file_types[EXTENSION_TEXTURE]		= File_Engine_Texture;
+		g_file_types[EXTENSION_SHADER]		= File_Engine_Shader;
+		g_file_types[METADATA_EXTENSION]	= File_Engine_Metadata;
 	}
 
 	bool FileSystem::CreateDirectory_(const string& path)
@@ -179,6 +271,7 @@ namespace Directus
 		try
 		{
 			result = create_directories(path);
+			InvalidateDirectoryCache(path);
 		}
 		catch (filesystem_error& e)
 		{
@@ -194,6 +287,7 @@ namespace Directus
 		try
 		{
 			result = remove_all(directory);
+			InvalidateDirectoryCache(directory);
 		}
 		catch (filesystem_error& e)
 		{
@@ -240,6 +334,13 @@ namespace Directus
 
 	bool FileSystem::FileExists(const string& file_path)
 	{
+		// Shipped files are in the pack, which saves asking the disk
+		if (const auto pack = PackFile::GetMounted())
+		{
+			if (pack->Find(file_path, nullptr))
+				return true;
+		}
+
 		bool result = false;
 		try
 		{
@@ -263,6 +364,7 @@ namespace Directus
 		try
 		{
 			result = remove(file_path.c_str()) == 0;
+			InvalidateDirectoryCache(file_path);
 		}
 		catch (filesystem_error& e)
 		{
@@ -287,6 +389,7 @@ namespace Directus
 		try 
 		{
 			result = copy_file(source, destination, copy_options::overwrite_existing);
+			InvalidateDirectoryCache(destination);
 		}
 		catch (filesystem_error& e) 
 		{
@@ -347,13 +450,9 @@ namespace Directus
 	vector<string> FileSystem::GetDirectoriesInDirectory(const string& directory)
 	{
 		vector<string> subDirs;
-		directory_iterator end_itr; // default construction yields past-the-end
-		for (directory_iterator itr(directory); itr != end_itr; ++itr)
+		for (const auto& name : list_directory(directory).directories)
 		{
-			if (!is_directory(itr->status()))
-				continue;
-
-			subDirs.emplace_back(itr->path().generic_string());
+			subDirs.emplace_back((path(directory) / name).generic_string());
 		}
 
 		return subDirs;
@@ -362,45 +461,40 @@ namespace Directus
 	vector<string> FileSystem::GetFilesInDirectory(const string& directory)
 	{
 		vector<string> filePaths;
-		directory_iterator end_itr; // default construction yields past-the-end
-		for (directory_iterator itr(directory); itr != end_itr; ++itr)
+		for (const auto& name : list_directory(directory).files)
 		{
-			if (!is_regular_file(itr->status()))
-				continue;
-
-			filePaths.emplace_back(itr->path().generic_string());
+			filePaths.emplace_back((path(directory) / name).generic_string());
 		}
 
 		return filePaths;
 	}
 
-	vector<string> FileSystem::GetSupportedFilesInDirectory(const string& directory)
+	void FileSystem::InvalidateDirectoryCache(const string& file_path)
 	{
-		vector<string> filesInDirectory		= GetFilesInDirectory(directory);
-		vector<string> imagesInDirectory	= GetSupportedImageFilesFromPaths(filesInDirectory); // get all the images
-		vector<string> scriptsInDirectory	= GetSupportedScriptFilesFromPaths(filesInDirectory); // get all the scripts
-		vector<string> modelsInDirectory	= GetSupportedModelFilesFromPaths(filesInDirectory); // get all the models
-		vector<string> supportedFiles;
-
-		// get supported images
-		for (const auto& imageInDirectory : imagesInDirectory)
-		{
-			supportedFiles.emplace_back(imageInDirectory);
-		}
+		const auto key = directory_key(file_path);
 
-		// get supported scripts
-		for (const auto& scriptInDirectory : scriptsInDirectory)
-		{
-			supportedFiles.emplace_back(scriptInDirectory);
-		}
+		lock_guard<mutex> lock(g_directories_mutex);
+		g_directories.erase(key);
+		g_directories.erase(path(key).parent_path().generic_string());
+	}
 
-		// get supported models
-		for (const auto& modelInDirectory : modelsInDirectory)
+	vector<string> FileSystem::GetSupportedFilesInDirectory(const string& directory)
+	{
+		// Images first, then scripts, then models
+		vector<string> images;
+		vector<string> scripts;
+		vector<string> models;
+		for (auto& file : GetFilesInDirectory(directory))
 		{
-			supportedFiles.emplace_back(modelInDirectory);
+			const auto type = GetFileType(file);
+			if (type == File_Image || type == File_Engine_Texture)	images.emplace_back(move(file));
+			else if (type == File_Script)							scripts.emplace_back(move(file));
+			else if (type == File_Model)							models.emplace_back(move(file));
 		}
 
-		return supportedFiles;
+		images.insert(images.end(), make_move_iterator(scripts.begin()), make_move_iterator(scripts.end()));
+		images.insert(images.end(), make_move_iterator(models.begin()), make_move_iterator(models.end()));
+		return images;
 	}
 
 	vector<string> FileSystem::GetSupportedImageFilesFromPaths(const vector<string>& paths)
@@ -480,131 +574,98 @@ namespace Directus
 		return sceneFiles;
 	}
 
-	bool FileSystem::IsSupportedAudioFile(const string& path)
+	File_Type FileSystem::GetFileType(const string_view path)
 	{
-		string fileExt = GetExtensionFromFilePath(path);
+		// The extension of the file name (a dot in a directory name doesn't count)
+		const auto dot			= path.find_last_of('.');
+		const auto separator	= path.find_last_of("\\/");
+		if (dot == string_view::npos || (separator != string_view::npos && dot < separator))
+			return File_Unknown;
 
-		auto supportedFormats = GetSupportedAudioFormats();
-		for (const auto& format : supportedFormats)
+		// Lower case, on the stack
+		const auto extension = path.substr(dot);
+		char extension_lower[g_extension_length_max];
+		if (extension.size() > g_extension_length_max)
+			return File_Unknown;
+
+		for (size_t i = 0; i < extension.size(); i++)
 		{
-			if (fileExt == format || fileExt == ConvertToUppercase(format))
-				return true;
+			extension_lower[i] = static_cast<char>(tolower(static_cast<unsigned char>(extension[i])));
 		}
 
-		return false;
+		const auto it = g_file_types.find(string_view(extension_lower, extension.size()));
+		return it != g_file_types.end() ? it->second : File_Unknown;
 	}
 
-	bool FileSystem::IsSupportedImageFile(const string& path)
+	bool FileSystem::IsSupportedAudioFile(const string& path)
 	{
-		string fileExt = GetExtensionFromFilePath(path);
-
-		auto supportedFormats = GetSupportedImageFormats();
-		for (const auto& format : supportedFormats)
-		{
-			if (fileExt == format || fileExt == ConvertToUppercase(format))
-				return true;
-		}
-		
-		if (GetExtensionFromFilePath(path) == EXTENSION_TEXTURE)
-			return true;
+		return GetFileType(path) == File_Audio;
+	}
 
-		return false;
+	bool FileSystem::IsSupportedImageFile(const string& path)
+	{
+		const auto type = GetFileType(path);
+		return type == File_Image || type == File_Engine_Texture;
 	}
 
 	bool FileSystem::IsSupportedModelFile(const string& path)
 	{
-		string fileExt = GetExtensionFromFilePath(path);
-
-		auto supportedFormats = GetSupportedModelFormats();
-		for (const auto& format : supportedFormats)
-		{
-			if (fileExt == format || fileExt == ConvertToUppercase(format))
-				return true;
-		}
-
-		return false;
+		return GetFileType(path) == File_Model;
 	}
 
 	bool FileSystem::IsSupportedShaderFile(const string& path)
 	{
-		string fileExt = GetExtensionFromFilePath(path);
-
-		auto supportedFormats = GetSupportedShaderFormats();
-		for (const auto& format : supportedFormats)
-		{
-			if (fileExt == format || fileExt == ConvertToUppercase(format))
-				return true;
-		}
-
-		return false;
+		return GetFileType(path) == File_Shader;
 	}
 
 	bool FileSystem::IsSupportedFontFile(const string& path)
 	{
-		string fileExt = GetExtensionFromFilePath(path);
-
-		auto supportedFormats = GetSupportedFontFormats();
-		for (const auto& format : supportedFormats)
-		{
-			if (fileExt == format || fileExt == ConvertToUppercase(format))
-				return true;
-		}
-
-		return false;
+		return GetFileType(path) == File_Font;
 	}
 
 	bool FileSystem::IsEngineScriptFile(const string& path)
 	{
-		string fileExt = GetExtensionFromFilePath(path);
-
-		auto supportedFormats = GetSupportedScriptFormats();
-		for (const auto& format : supportedFormats)
-		{
-			if (fileExt == format || fileExt == ConvertToUppercase(format))
-				return true;
-		}
-
-		return false;
+		return GetFileType(path) == File_Script;
 	}
 
 	bool FileSystem::IsEnginePrefabFile(const string& filePath)
 	{
-		return GetExtensionFromFilePath(filePath) == EXTENSION_PREFAB;
+		return GetFileType(filePath) == File_Engine_Prefab;
 	}
 
 	bool FileSystem::IsEngineModelFile(const string& filePath)
 	{
-		return GetExtensionFromFilePath(filePath) == EXTENSION_MODEL;
+		return GetFileType(filePath) == File_Engine_Model;
 	}
 
 	bool FileSystem::IsEngineMaterialFile(const string& filePath)
 	{
-		return GetExtensionFromFilePath(filePath) == EXTENSION_MATERIAL;
+		return GetFileType(filePath) == File_Engine_Material;
 	}
 
 	bool FileSystem::IsEngineMeshFile(const string& filePath)
 	{
-		return GetExtensionFromFilePath(filePath) == EXTENSION_MESH;
+		return GetFileType(filePath) == File_Engine_Mesh;
 	}
 
 	bool FileSystem::IsEngineSceneFile(const string& filePath)
 	{
-		return GetExtensionFromFilePath(filePath) == EXTENSION_WORLD;
+		return GetFileType(filePath) == File_Engine_World;
 	}
 
 	bool FileSystem::IsEngineTextureFile(const string& filePath)
 	{
-		return GetExtensionFromFilePath(filePath) == EXTENSION_TEXTURE;
+		return GetFileType(filePath) == File_Engine_Texture;
 	}
 
 	bool FileSystem::IsEngineShaderFile(const string& filePath)
 	{
-		return GetExtensionFromFilePath(filePath) == EXTENSION_SHADER;
+		return GetFileType(filePath) == File_Engine_Shader;
 	}
 
 	bool FileSystem::IsEngineMetadataFile(const string& filePath)
 	{
-		return GetExtensionFromFilePath(filePath) == METADATA_EXTENSION;
+		return GetFileType(filePath) == File_Engine_Metadata;
 	}
 
 	// Returns a file path which is relative to the engine's executable
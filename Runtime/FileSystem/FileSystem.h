@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include <vector>
+#include <string_view>
 #include "../Core/EngineDefs.h"
 //=============================
 
@@ -35,7 +36,9 @@ static const char* METADATA_TYPE_TEXTURE	= "Texture";
 static const char* METADATA_TYPE_AUDIOCLIP	= "Audio_Clip";
 // Engine file extensions
 static const char* EXTENSION_WORLD			= ".world";
+static const char* EXTENSION_WORLD_CELL		= ".world_cell";
 static const char* EXTENSION_MATERIAL		= ".mat";
+static const char* EXTENSION_MATERIAL_BINARY	= ".mat_bin";
 static const char* EXTENSION_MODEL			= ".model";
 static const char* EXTENSION_PREFAB			= ".prefab";
 static const char* EXTENSION_SHADER			= ".shader";
@@ -45,6 +48,25 @@ static const char* EXTENSION_MESH			= ".mesh";
 
 namespace Directus
 {
+	enum File_Type
+	{
+		File_Unknown,
+		File_Image,
+		File_Audio,
+		File_Model,
+		File_Shader,
+		File_Script,
+		File_Font,
+		File_Engine_Prefab,
+		File_Engine_Model,
+		File_Engine_Material,
+		File_Engine_Mesh,
+		File_Engine_World,
+		File_Engine_Texture,
+		File_Engine_Shader,
+		File_Engine_Metadata
+	};
+
 	class ENGINE_CLASS FileSystem
 	{
 	public:
@@ -75,6 +97,8 @@ namespace Directus
 		static std::string GetParentDirectory(const std::string& directory);
 		static std::vector<std::string> GetDirectoriesInDirectory(const std::string& directory);
 		static std::vector<std::string> GetFilesInDirectory(const std::string& directory);
+		// Listings are cached until the directory changes, this drops them right away (for a file or directory, and its parent)
+		static void InvalidateDirectoryCache(const std::string& path);
 		//======================================================================================
 
 		//= SUPPORTED FILES IN DIRECTORY ======================================================================
@@ -87,7 +111,9 @@ namespace Directus
 		static std::vector<std::string> GetSupportedSceneFilesInDirectory(const std::string& directory);
 		//======================================================================================================
 
-		//= SUPPORTED FILE CHECKS =====================================	
+		//= SUPPORTED FILE CHECKS =====================================
+		// Case insensitive, by extension, doesn't allocate
+		static File_Type GetFileType(std::string_view path);
 		static bool IsSupportedAudioFile(const std::string& path);
 		static bool IsSupportedImageFile(const std::string& path);	
 		static bool IsSupportedModelFile(const std::string& path);
@@ -0,0 +1,304 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==============
+#include "FileWatcher.h"
+#include <filesystem>
+#include "../Logging/Log.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+//=========================
+
+//= NAMESPACES ==============
+using namespace std;
+using namespace std::chrono;
+//===========================
+
+namespace Directus
+{
+	namespace
+	{
+		// How long a file has to be quiet before its change is reported
+		const milliseconds g_debounce		= milliseconds(150);
+		// How often the watching thread checks if it should stop
+		const int g_wait_ms					= 100;
+		const size_t g_event_buffer_size	= 64 * 1024;
+		// How long after the engine wrote a file its changes are ignored
+		const milliseconds g_ignore_window	= milliseconds(2000);
+
+		// Files written by the engine, by when they were written (shared by every watcher)
+		unordered_map<string, steady_clock::time_point> g_writes;
+		mutex g_writes_mutex;
+
+		string normalize(const string& file_path)
+		{
+			error_code error;
+			const auto path = filesystem::absolute(file_path, error);
+			return (error ? filesystem::path(file_path) : path).lexically_normal().generic_string();
+		}
+
+		// Temporary files written by FileStream (and most editors) before they replace the actual file
+		bool is_temporary(const string& file_path)
+		{
+			const auto extension = filesystem::path(file_path).extension().string();
+			return extension == ".tmp" || extension == ".TMP" || (!extension.empty() && extension.back() == '~');
+		}
+	}
+
+	FileWatcher::FileWatcher(const vector<string>& directories)
+	{
+		for (const auto& directory : directories)
+		{
+			error_code error;
+			const auto path = filesystem::absolute(directory, error);
+			if (!error && filesystem::is_directory(path, error))
+			{
+				m_directories.emplace_back(path.generic_string());
+			}
+		}
+
+		m_thread = thread(&FileWatcher::Watch, this);
+	}
+
+	FileWatcher::~FileWatcher()
+	{
+		m_running = false;
+		if (m_thread.joinable())
+		{
+			m_thread.join();
+		}
+	}
+
+	vector<string> FileWatcher::Poll()
+	{
+		vector<string> changed;
+		const auto now = steady_clock::now();
+
+		// Forget old writes, there are only as many as were saved in the last couple of seconds
+		{
+			lock_guard<mutex> lock(g_writes_mutex);
+			for (auto it = g_writes.begin(); it != g_writes.end();)
+			{
+				it = now - it->second > g_ignore_window ? g_writes.erase(it) : next(it);
+			}
+		}
+
+		lock_guard<mutex> lock(m_changes_mutex);
+		for (auto it = m_changes.begin(); it != m_changes.end();)
+		{
+			if (now - it->second < g_debounce)
+			{
+				++it;
+				continue;
+			}
+
+			changed.emplace_back(it->first);
+			it = m_changes.erase(it);
+		}
+
+		return changed;
+	}
+
+	void FileWatcher::IgnoreWrite(const string& file_path)
+	{
+		const auto path = normalize(file_path);
+
+		lock_guard<mutex> lock(g_writes_mutex);
+		g_writes[path] = steady_clock::now();
+	}
+
+	void FileWatcher::OnChanged(const string& file_path)
+	{
+		if (is_temporary(file_path))
+			return;
+
+		const auto path = filesystem::path(file_path).lexically_normal().generic_string();
+		const auto now	= steady_clock::now();
+		{
+			lock_guard<mutex> lock(g_writes_mutex);
+			const auto write = g_writes.find(path);
+			if (write != g_writes.end() && now - write->second <= g_ignore_window)
+				return;
+		}
+
+		lock_guard<mutex> lock(m_changes_mutex);
+		m_changes[path] = now;
+	}
+
+#ifdef _WIN32
+	void FileWatcher::Watch()
+	{
+		struct watch
+		{
+			string directory;
+			HANDLE handle = INVALID_HANDLE_VALUE;
+			OVERLAPPED overlapped = {};
+			vector<DWORD> buffer = vector<DWORD>(g_event_buffer_size / sizeof(DWORD));
+		};
+		vector<watch> watches(m_directories.size());
+		vector<HANDLE> events;
+
+		const DWORD filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE;
+		auto read = [filter](watch& w)
+		{
+			return ReadDirectoryChangesW(w.handle, w.buffer.data(), static_cast<DWORD>(w.buffer.size() * sizeof(DWORD)), TRUE, filter, nullptr, &w.overlapped, nullptr) != 0;
+		};
+
+		for (size_t i = 0; i < m_directories.size(); i++)
+		{
+			auto& w		= watches[i];
+			w.directory	= m_directories[i];
+			w.handle	= CreateFileA(w.directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+			w.overlapped.hEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+			if (w.handle == INVALID_HANDLE_VALUE || !read(w))
+			{
+				LOGF_WARNING("Failed to watch \"%s\".", w.directory.c_str());
+			}
+			events.emplace_back(w.overlapped.hEvent);
+		}
+
+		while (m_running && !events.empty())
+		{
+			const auto result = WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE, g_wait_ms);
+			if (result < WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + events.size())
+				continue;
+
+			auto& w = watches[result - WAIT_OBJECT_0];
+			DWORD bytes = 0;
+			if (GetOverlappedResult(w.handle, &w.overlapped, &bytes, FALSE) && bytes != 0)
+			{
+				auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(w.buffer.data());
+				while (true)
+				{
+					const auto length	= static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+					const auto size		= WideCharToMultiByte(CP_UTF8, 0, info->FileName, length, nullptr, 0, nullptr, nullptr);
+					string name(size, '\0');
+					WideCharToMultiByte(CP_UTF8, 0, info->FileName, length, name.data(), size, nullptr, nullptr);
+
+					// Directories are only reported when they are added, removed or renamed
+					const auto file_path = w.directory + "/" + name;
+					if (info->Action != FILE_ACTION_MODIFIED || !filesystem::is_directory(file_path))
+					{
+						OnChanged(file_path);
+					}
+
+					if (info->NextEntryOffset == 0)
+						break;
+					info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(reinterpret_cast<const char*>(info) + info->NextEntryOffset);
+				}
+			}
+
+			read(w);
+		}
+
+		for (auto& w : watches)
+		{
+			if (w.handle != INVALID_HANDLE_VALUE)
+			{
+				CancelIo(w.handle);
+				CloseHandle(w.handle);
+			}
+			CloseHandle(w.overlapped.hEvent);
+		}
+	}
+#else
+	void FileWatcher::Watch()
+	{
+		const auto file = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (file == -1)
+		{
+			LOG_WARNING("Failed to initialize inotify, files won't be watched.");
+			return;
+		}
+
+		// inotify isn't recursive, every directory gets a watch of its own
+		unordered_map<int, string> directories;
+		auto add = [file, &directories](const string& root)
+		{
+			auto add_one = [file, &directories](const string& directory)
+			{
+				const auto descriptor = inotify_add_watch(file, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE | IN_DELETE | IN_MOVED_FROM);
+				if (descriptor != -1)
+				{
+					directories[descriptor] = directory;
+				}
+			};
+
+			add_one(root);
+			error_code error;
+			for (auto it = filesystem::recursive_directory_iterator(root, error); !error && it != filesystem::recursive_directory_iterator(); it.increment(error))
+			{
+				if (it->is_directory(error))
+				{
+					add_one(it->path().generic_string());
+				}
+			}
+		};
+
+		for (const auto& directory : m_directories)
+		{
+			add(directory);
+		}
+
+		vector<char> buffer(g_event_buffer_size);
+		while (m_running)
+		{
+			pollfd descriptor = { file, POLLIN, 0 };
+			if (poll(&descriptor, 1, g_wait_ms) <= 0)
+				continue;
+
+			const auto bytes = read(file, buffer.data(), buffer.size());
+			for (ssize_t offset = 0; offset < bytes;)
+			{
+				const auto event	= reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+				offset				+= sizeof(inotify_event) + event->len;
+
+				const auto directory = directories.find(event->wd);
+				if (directory == directories.end() || event->len == 0)
+					continue;
+
+				const auto file_path = directory->second + "/" + event->name;
+				if (event->mask & IN_ISDIR)
+				{
+					// New directories are watched too
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					{
+						add(file_path);
+					}
+					OnChanged(file_path);
+				}
+				// A created file is reported once it's closed
+				else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM))
+				{
+					OnChanged(file_path);
+				}
+			}
+		}
+
+		close(file);
+	}
+#endif
+}
@@ -0,0 +1,63 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==============
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include "../Core/EngineDefs.h"
+//=========================
+
+namespace Directus
+{
+	// Watches directories (and their sub-directories) from a thread of its own. Saving a file usually touches
+	// it more than once, so a change is only reported once the file has been quiet for a while.
+	class ENGINE_CLASS FileWatcher
+	{
+	public:
+		FileWatcher(const std::vector<std::string>& directories);
+		~FileWatcher();
+
+		// Returns the (absolute) paths of the files which changed (or were removed, directories included) and have been quiet since
+		std::vector<std::string> Poll();
+
+		// The engine reports the files it writes, so saving them doesn't come back as a change to reload
+		static void IgnoreWrite(const std::string& file_path);
+
+	private:
+		void Watch();
+		void OnChanged(const std::string& file_path);
+
+		std::vector<std::string> m_directories;
+		std::thread m_thread;
+		std::atomic<bool> m_running = true;
+
+		// Changed files, by when they last changed
+		std::unordered_map<std::string, std::chrono::steady_clock::time_point> m_changes;
+		std::mutex m_changes_mutex;
+	};
+}
@@ -0,0 +1,246 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========
+#include "Compression.h"
+#include <cstring>
+#include <cstdint>
+#include <vector>
+//=====================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+// A block is a list of sequences: [token][literal length+][literals][offset (2 bytes)][match length+]
+// The token holds the literal length in its high nibble and the match length (minus the minimum) in the low one,
+// a nibble of 15 means the length continues in the following bytes (each adding up to 255).
+// The last sequence has no match, the block ends right after its literals.
+
+namespace Directus
+{
+	namespace
+	{
+		const size_t g_match_min		= 4;
+		const size_t g_match_offset_max	= 0xFFFF;
+		const size_t g_end_literals		= 5; // the tail is always literals, so the last sequence is never a match
+		const unsigned int g_hash_bits	= 14;
+
+		uint32_t read_32(const uint8_t* source)
+		{
+			uint32_t value;
+			memcpy(&value, source, sizeof(value));
+			return value;
+		}
+
+		uint32_t hash(const uint32_t sequence)
+		{
+			return (sequence * 2654435761u) >> (32 - g_hash_bits);
+		}
+
+		// Bytes needed to encode a length past its nibble
+		size_t length_extra(const size_t length)
+		{
+			return length >= 15 ? (length - 15) / 255 + 1 : 0;
+		}
+
+		uint8_t* write_length(uint8_t* destination, size_t length)
+		{
+			if (length < 15)
+				return destination;
+
+			length -= 15;
+			while (length >= 255)
+			{
+				*destination++ = 255;
+				length -= 255;
+			}
+			*destination++ = static_cast<uint8_t>(length);
+			return destination;
+		}
+
+		bool read_length(const uint8_t** source, const uint8_t* source_end, size_t* length)
+		{
+			if (*length != 15)
+				return true;
+
+			uint8_t value;
+			do
+			{
+				if (*source >= source_end)
+					return false;
+
+				value = *(*source)++;
+				*length += value;
+			} while (value == 255);
+
+			return true;
+		}
+	}
+
+	size_t Compression::CompressBlock(const byte* source, const size_t size, byte* destination, const size_t destination_size)
+	{
+		const auto src		= reinterpret_cast<const uint8_t*>(source);
+		const auto dst_start	= reinterpret_cast<uint8_t*>(destination);
+		const auto dst_end	= dst_start + destination_size;
+		auto dst			= dst_start;
+
+		// Last position a match can start at, and the end of the region matches can cover
+		const size_t match_end		= size > g_end_literals ? size - g_end_literals : 0;
+		const size_t match_start_end	= match_end > g_match_min ? match_end - g_match_min : 0;
+
+		vector<uint32_t> table(size_t(1) << g_hash_bits, 0);
+		size_t anchor	= 0;
+		size_t position	= 0;
+
+		while (position < match_start_end)
+		{
+			const auto sequence		= read_32(src + position);
+			const auto slot			= hash(sequence);
+			const size_t candidate	= table[slot];
+			table[slot]				= static_cast<uint32_t>(position);
+
+			if (candidate >= position || position - candidate > g_match_offset_max || read_32(src + candidate) != sequence)
+			{
+				// Step faster through data that doesn't compress
+				position += 1 + ((position - anchor) >> 6);
+				continue;
+			}
+
+			size_t match_length = g_match_min;
+			while (position + match_length < match_end && src[candidate + match_length] == src[position + match_length])
+			{
+				match_length++;
+			}
+
+			const auto literal_length	= position - anchor;
+			const auto sequence_size	= 1 + length_extra(literal_length) + literal_length + 2 + length_extra(match_length - g_match_min);
+			if (sequence_size > static_cast<size_t>(dst_end - dst))
+				return 0;
+
+			const auto match_code	= match_length - g_match_min;
+			*dst++					= static_cast<uint8_t>(((literal_length < 15 ? literal_length : 15) << 4) | (match_code < 15 ? match_code : 15));
+			dst						= write_length(dst, literal_length);
+			memcpy(dst, src + anchor, literal_length);
+			dst						+= literal_length;
+
+			const auto offset	= position - candidate;
+			*dst++				= static_cast<uint8_t>(offset & 0xFF);
+			*dst++				= static_cast<uint8_t>(offset >> 8);
+			dst					= write_length(dst, match_code);
+
+			position	+= match_length;
+			anchor		= position;
+		}
+
+		// Last sequence, literals only
+		const auto literal_length = size - anchor;
+		if (1 + length_extra(literal_length) + literal_length > static_cast<size_t>(dst_end - dst))
+			return 0;
+
+		*dst++	= static_cast<uint8_t>((literal_length < 15 ? literal_length : 15) << 4);
+		dst		= write_length(dst, literal_length);
+		memcpy(dst, src + anchor, literal_length);
+		dst		+= literal_length;
+
+		return static_cast<size_t>(dst - dst_start);
+	}
+
+	bool Compression::DecompressBlock(const byte* source, const size_t size, byte* destination, const size_t destination_size)
+	{
+		auto src			= reinterpret_cast<const uint8_t*>(source);
+		const auto src_end	= src + size;
+		const auto dst_start	= reinterpret_cast<uint8_t*>(destination);
+		const auto dst_end	= dst_start + destination_size;
+		auto dst			= dst_start;
+
+		while (src < src_end)
+		{
+			const auto token = *src++;
+
+			// Literals
+			size_t literal_length = token >> 4;
+			if (!read_length(&src, src_end, &literal_length))
+				return false;
+
+			if (literal_length > static_cast<size_t>(src_end - src) || literal_length > static_cast<size_t>(dst_end - dst))
+				return false;
+
+			// Short runs are copied as a fixed 16 bytes when there's room, which is a couple of moves instead of a memcpy call
+			if (literal_length <= 16 && src_end - src >= 16 && dst_end - dst >= 16)
+			{
+				memcpy(dst, src, 16);
+			}
+			else
+			{
+				memcpy(dst, src, literal_length);
+			}
+			src += literal_length;
+			dst += literal_length;
+
+			// The last sequence has no match
+			if (src == src_end)
+				break;
+
+			// Match
+			if (src_end - src < 2)
+				return false;
+
+			const size_t offset = src[0] | (src[1] << 8);
+			src += 2;
+			if (offset == 0 || offset > static_cast<size_t>(dst - dst_start))
+				return false;
+
+			size_t match_length = token & 15;
+			if (!read_length(&src, src_end, &match_length))
+				return false;
+
+			match_length += g_match_min;
+			if (match_length > static_cast<size_t>(dst_end - dst))
+				return false;
+
+			const auto match = dst - offset;
+			if (match_length <= 16 && offset >= 16 && dst_end - dst >= 16)
+			{
+				memcpy(dst, match, 16);
+			}
+			else if (offset >= match_length)
+			{
+				memcpy(dst, match, match_length);
+			}
+			else
+			{
+				// Overlapping, the first offset bytes repeat, so copy them once and keep doubling what's been copied
+				memcpy(dst, match, offset);
+				size_t copied = offset;
+				while (copied < match_length)
+				{
+					const auto count = copied < match_length - copied ? copied : match_length - copied;
+					memcpy(dst + copied, dst, count);
+					copied += count;
+				}
+			}
+			dst += match_length;
+		}
+
+		return dst == dst_end;
+	}
+}
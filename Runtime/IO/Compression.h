@@ -0,0 +1,42 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==============
+#include <cstddef>
+#include "../Core/EngineDefs.h"
+//=========================
+
+namespace Directus
+{
+	// LZ77 family block codec (LZ4 style sequences, 64KB window), it trades ratio for decompression speed.
+	// Blocks are independent, so a large array split into blocks can be (de)compressed in parallel.
+	class ENGINE_CLASS Compression
+	{
+	public:
+		// Returns the compressed size, or 0 if the result doesn't fit in destination_size (incompressible data should be stored as is)
+		static size_t CompressBlock(const std::byte* source, size_t size, std::byte* destination, size_t destination_size);
+
+		// Fails if the data is corrupt or doesn't decompress to exactly destination_size bytes, never writes outside the destination
+		static bool DecompressBlock(const std::byte* source, size_t size, std::byte* destination, size_t destination_size);
+	};
+}
@@ -19,13 +19,27 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =================
+//= INCLUDES =========================
 #include "FileStream.h"
 #include <iostream>
+#include <filesystem>
+#include "PackFile.h"
+#include "Compression.h"
+#include "../FileSystem/FileSystem.h"
+#include "../FileSystem/FileWatcher.h"
 #include "../World/Entity.h"
 #include "../Logging/Log.h"
 #include "../RHI/RHI_Vertex.h"
-//============================
+#include "../Threading/Threading.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+//====================================
 
 //= NAMESPACES =====
 using namespace std;
@@ -33,20 +47,98 @@ using namespace std;
 
 namespace Directus
 {
+	namespace
+	{
+		// Maps the whole file for reading, an empty file gives a null mapping
+		bool map_file(const string& path, const byte** data, size_t* size, void** handle)
+		{
+#ifdef _WIN32
+			const auto file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file == INVALID_HANDLE_VALUE)
+				return false;
+
+			LARGE_INTEGER file_size;
+			if (!GetFileSizeEx(file, &file_size))
+			{
+				CloseHandle(file);
+				return false;
+			}
+
+			*size = static_cast<size_t>(file_size.QuadPart);
+			if (*size != 0)
+			{
+				// The mapping keeps the file open, so the file handle isn't needed past this point
+				*handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				*data	= *handle ? static_cast<const byte*>(MapViewOfFile(*handle, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+			}
+			CloseHandle(file);
+
+			return *size == 0 || *data;
+#else
+			const auto file = open(path.c_str(), O_RDONLY);
+			if (file == -1)
+				return false;
+
+			struct stat file_stat;
+			if (fstat(file, &file_stat) != 0)
+			{
+				close(file);
+				return false;
+			}
+
+			*size = static_cast<size_t>(file_stat.st_size);
+			if (*size != 0)
+			{
+				auto mapping = mmap(nullptr, *size, PROT_READ, MAP_PRIVATE, file, 0);
+				if (mapping != MAP_FAILED)
+				{
+					madvise(mapping, *size, MADV_SEQUENTIAL);
+					*data = static_cast<const byte*>(mapping);
+				}
+			}
+			close(file);
+
+			return *size == 0 || *data;
+#endif
+		}
+
+		void unmap_file(const byte* data, const size_t size, void* handle)
+		{
+#ifdef _WIN32
+			if (data)	UnmapViewOfFile(data);
+			if (handle)	CloseHandle(handle);
+#else
+			if (data)	munmap(const_cast<byte*>(data), size);
+#endif
+		}
+	}
+
 	FileStream::FileStream(const string& path, FileStreamMode mode)
 	{
 		m_isOpen = false;
 		m_mode = mode;
 
-		if (mode == FileStreamMode_Write)
+		if (mode == FileStreamMode_Write || mode == FileStreamMode_WriteDeferred)
 		{
-			out.open(path, ios::out | ios::binary);
-			if (out.fail())
+			// Written next to the target and moved over it on Close(), so a failed or interrupted save never leaves a half written file
+			m_path		= path;
+			m_path_temp	= path + ".tmp";
+
+			if (mode == FileStreamMode_Write)
 			{
-				LOGF_ERROR("Failed to open \"%s\" for writing", path.c_str());
-				return;
+				m_write_buffer.reserve(m_write_block_size);
+				out.open(m_path_temp, ios::out | ios::binary);
+				if (out.fail())
+				{
+					LOGF_ERROR("Failed to open \"%s\" for writing", path.c_str());
+					return;
+				}
 			}
 		}
+		else if ((mode == FileStreamMode_Read || mode == FileStreamMode_ReadMapped) && OpenPacked(path))
+		{
+			// Mapped by the pack
+		}
 		else if (mode == FileStreamMode_Read)
 		{
 			in.open(path, ios::in | ios::binary);
@@ -56,22 +148,304 @@ namespace Directus
 				return;
 			}
 		}
+		else if (mode == FileStreamMode_ReadMapped)
+		{
+			if (!map_file(path, &m_map, &m_map_size, &m_map_handle))
+			{
+				LOGF_ERROR("Failed to map \"%s\" for reading", path.c_str());
+				return;
+			}
+		}
 
 		m_isOpen = true;
 	}
 
 	FileStream::~FileStream()
 	{
-		if (m_mode == FileStreamMode_Write)
+		if (m_mode == FileStreamMode_Write || m_mode == FileStreamMode_WriteDeferred)
 		{
-			out.flush();
-			out.close();
+			Close();
 		}
 		else if (m_mode == FileStreamMode_Read)
 		{
 			in.clear();
 			in.close();
 		}
+		else if (m_mode == FileStreamMode_ReadMapped && !m_map_packed)
+		{
+			unmap_file(m_map, m_map_size, m_map_handle);
+		}
+	}
+
+	bool FileStream::OpenPacked(const string& path)
+	{
+		const auto pack = PackFile::GetMounted();
+		PackFile::Entry entry;
+		if (!pack || !pack->Find(path, &entry))
+			return false;
+
+		const auto mode	= m_mode;
+		m_mode			= FileStreamMode_ReadMapped;
+		m_map_packed	= true;
+		m_map			= entry.data;
+		m_map_size		= entry.size;
+
+		// Compressed entries are decompressed in one go, then read like any other mapping
+		if (entry.compressed)
+		{
+			m_map_buffer.resize(ReadAs<unsigned int>());
+			if (!ReadCompressedBytes(m_map_buffer.data(), m_map_buffer.size(), nullptr))
+			{
+				// Left as if the pack didn't have it, so the file on disk is tried instead
+				LOGF_WARNING("Failed to decompress \"%s\" from the pack", path.c_str());
+				m_mode			= mode;
+				m_map_packed	= false;
+				m_map			= nullptr;
+				m_map_size		= 0;
+				m_map_offset	= 0;
+				m_map_buffer.clear();
+				m_map_buffer.shrink_to_fit();
+				return false;
+			}
+			m_map			= m_map_buffer.data();
+			m_map_size		= m_map_buffer.size();
+			m_map_offset	= 0;
+		}
+
+		return true;
+	}
+
+	bool FileStream::Close()
+	{
+		if (!m_isOpen || (m_mode != FileStreamMode_Write && m_mode != FileStreamMode_WriteDeferred))
+			return false;
+		m_isOpen = false;
+
+		if (m_mode == FileStreamMode_WriteDeferred)
+		{
+			out.open(m_path_temp, ios::out | ios::binary);
+			if (out.fail())
+			{
+				LOGF_ERROR("Failed to open \"%s\" for writing", m_path.c_str());
+				return false;
+			}
+		}
+
+		WriteFlush();
+		out.close();
+
+		// Replace the target with the complete file
+		error_code error;
+		if (!m_write_failed && !out.fail())
+		{
+			FileWatcher::IgnoreWrite(m_path);
+			filesystem::rename(m_path_temp, m_path, error);
+			FileSystem::InvalidateDirectoryCache(m_path);
+		}
+		if (m_write_failed || out.fail() || error)
+		{
+			LOGF_ERROR("Failed to write \"%s\"", m_path.c_str());
+			filesystem::remove(m_path_temp, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	uint64_t FileStream::GetPosition()
+	{
+		if (m_mode == FileStreamMode_Write || m_mode == FileStreamMode_WriteDeferred)
+			return m_write_flushed + m_write_buffer.size();
+
+		if (m_mode == FileStreamMode_ReadMapped)
+			return m_map_offset;
+
+		return static_cast<uint64_t>(in.tellg());
+	}
+
+	void FileStream::Seek(const uint64_t position)
+	{
+		if (m_mode == FileStreamMode_ReadMapped)
+		{
+			m_map_offset = static_cast<size_t>(position < m_map_size ? position : m_map_size);
+		}
+		else if (m_mode == FileStreamMode_Read)
+		{
+			in.clear();
+			in.seekg(position);
+		}
+	}
+
+	uint64_t FileStream::GetSize()
+	{
+		if (m_mode == FileStreamMode_ReadMapped)
+			return m_map_size;
+
+		if (m_mode == FileStreamMode_Read)
+		{
+			const auto position = in.tellg();
+			in.seekg(0, ios::end);
+			const auto size = in.tellg();
+			in.seekg(position);
+			return static_cast<uint64_t>(size);
+		}
+
+		return GetPosition();
+	}
+
+	void FileStream::WriteArray(const void* source, const size_t size)
+	{
+		// Large arrays go straight to the file, instead of through the buffer
+		if (m_mode == FileStreamMode_Write && size >= m_write_block_size)
+		{
+			WriteFlush();
+			out.write(static_cast<const char*>(source), size);
+			m_write_failed |= out.fail();
+			m_write_flushed += size;
+			return;
+		}
+
+		WriteBytes(source, size);
+	}
+
+	void FileStream::WriteFlush()
+	{
+		if (m_write_buffer.empty() || !out.is_open())
+			return;
+
+		out.write(reinterpret_cast<const char*>(m_write_buffer.data()), m_write_buffer.size());
+		m_write_failed |= out.fail();
+		m_write_flushed += m_write_buffer.size();
+		m_write_buffer.clear();
+	}
+
+	void FileStream::CompressBytes(const void* source, const size_t size, Threading* threading, vector<byte>* destination)
+	{
+		// Layout: block count, stored size of each block, blocks.
+		// A block that doesn't shrink is stored as is, which is how the reader tells them apart (stored size == block size).
+		const auto bytes		= static_cast<const byte*>(source);
+		const auto block_count	= static_cast<unsigned int>((size + m_compression_block_size - 1) / m_compression_block_size);
+		vector<vector<byte>> blocks(block_count);
+
+		auto compress = [bytes, size, &blocks](const unsigned int start, const unsigned int end)
+		{
+			for (auto i = start; i < end; i++)
+			{
+				const auto offset		= static_cast<size_t>(i) * m_compression_block_size;
+				const auto block_size	= min(m_compression_block_size, size - offset);
+				auto& block				= blocks[i];
+
+				block.resize(block_size);
+				if (const auto compressed_size = Compression::CompressBlock(bytes + offset, block_size, block.data(), block_size - 1))
+				{
+					block.resize(compressed_size);
+				}
+				else
+				{
+					memcpy(block.data(), bytes + offset, block_size);
+				}
+			}
+		};
+
+		if (threading)
+		{
+			threading->AddTaskLoop(compress, block_count);
+		}
+		else
+		{
+			compress(0, block_count);
+		}
+
+		auto append = [destination](const void* data, const size_t data_size)
+		{
+			const auto data_bytes = static_cast<const byte*>(data);
+			destination->insert(destination->end(), data_bytes, data_bytes + data_size);
+		};
+
+		append(&block_count, sizeof(block_count));
+		for (const auto& block : blocks)
+		{
+			const auto block_size = static_cast<unsigned int>(block.size());
+			append(&block_size, sizeof(block_size));
+		}
+		for (const auto& block : blocks)
+		{
+			append(block.data(), block.size());
+		}
+	}
+
+	bool FileStream::ReadCompressedBytes(void* destination, const size_t size, Threading* threading)
+	{
+		const auto block_count = ReadAs<unsigned int>();
+		if (block_count != (size + m_compression_block_size - 1) / m_compression_block_size)
+		{
+			LOG_ERROR("Compressed array is corrupt");
+			return false;
+		}
+
+		vector<unsigned int> block_sizes(block_count);
+		vector<uint64_t> block_offsets(block_count);
+		uint64_t stored_size = 0;
+		for (unsigned int i = 0; i < block_count; i++)
+		{
+			Read(&block_sizes[i]);
+			block_offsets[i]	= stored_size;
+			stored_size			+= block_sizes[i];
+		}
+
+		// Mapped files decompress straight out of the mapping, streamed ones are read in one go first
+		const byte* stored = nullptr;
+		vector<byte> stored_buffer;
+		if (m_mode == FileStreamMode_ReadMapped)
+		{
+			stored = ReadMapped(static_cast<size_t>(stored_size));
+		}
+		else
+		{
+			stored_buffer.resize(static_cast<size_t>(stored_size));
+			in.read(reinterpret_cast<char*>(stored_buffer.data()), stored_buffer.size());
+			stored = in.fail() ? nullptr : stored_buffer.data();
+		}
+		if (!stored)
+			return false;
+
+		const auto bytes = static_cast<byte*>(destination);
+		atomic<bool> failed = false;
+		auto decompress = [bytes, size, stored, &block_sizes, &block_offsets, &failed](const unsigned int start, const unsigned int end)
+		{
+			for (auto i = start; i < end; i++)
+			{
+				const auto offset		= static_cast<size_t>(i) * m_compression_block_size;
+				const auto block_size	= min(m_compression_block_size, size - offset);
+				const auto block		= stored + block_offsets[i];
+
+				if (block_sizes[i] == block_size)
+				{
+					memcpy(bytes + offset, block, block_size);
+				}
+				else if (!Compression::DecompressBlock(block, block_sizes[i], bytes + offset, block_size))
+				{
+					failed = true;
+				}
+			}
+		};
+
+		if (threading)
+		{
+			threading->AddTaskLoop(decompress, block_count);
+		}
+		else
+		{
+			decompress(0, block_count);
+		}
+
+		if (failed)
+		{
+			LOG_ERROR("Compressed array is corrupt");
+			return false;
+		}
+
+		return true;
 	}
 
 	void FileStream::Write(const string& value)
@@ -79,7 +453,7 @@ namespace Directus
 		auto length = (unsigned int)value.length();
 		Write(length);
 
-		out.write(const_cast<char*>(value.c_str()), length);
+		WriteArray(value.data(), length);
 	}
 
 	void FileStream::Write(const vector<string>& value)
@@ -97,28 +471,28 @@ namespace Directus
 	{
 		auto length = (unsigned int)value.size();
 		Write(length);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(RHI_Vertex_PosUvNorTan) * length);
+		WriteArray(value.data(), sizeof(RHI_Vertex_PosUvNorTan) * length);
 	}
 
 	void FileStream::Write(const vector<unsigned int>& value)
 	{
 		auto length = (unsigned int)value.size();
 		Write(length);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(unsigned int) * length);
+		WriteArray(value.data(), sizeof(unsigned int) * length);
 	}
 
 	void FileStream::Write(const vector<unsigned char>& value)
 	{
 		auto size = (unsigned int)value.size();
 		Write(size);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(unsigned char) * size);
+		WriteArray(value.data(), sizeof(unsigned char) * size);
 	}
 
 	void FileStream::Write(const vector<std::byte>& value)
 	{
 		auto size = (unsigned int)value.size();
 		Write(size);
-		out.write(reinterpret_cast<const char*>(&value[0]), sizeof(std::byte) * size);
+		WriteArray(value.data(), sizeof(std::byte) * size);
 	}
 
 	void FileStream::Read(string* value)
@@ -126,6 +500,19 @@ namespace Directus
 		unsigned int length = 0;
 		Read(&length);
 
+		if (m_mode == FileStreamMode_ReadMapped)
+		{
+			if (const auto data = ReadMapped(length))
+			{
+				value->assign(reinterpret_cast<const char*>(data), length);
+			}
+			else
+			{
+				value->clear();
+			}
+			return;
+		}
+
 		value->resize(length);
 		in.read(const_cast<char*>(value->c_str()), length);
 	}
@@ -149,67 +536,49 @@ namespace Directus
 		}
 	}
 
-	void FileStream::Read(vector<RHI_Vertex_PosUvNorTan>* vec)
-	{
-		if (!vec)
-			return;
-
-		vec->clear();
-		vec->shrink_to_fit();
-
-		auto length = ReadAs<unsigned int>();
+	void FileStream::Read(vector<RHI_Vertex_PosUvNorTan>* vec)	{ ReadVector(vec); }
+	void FileStream::Read(vector<unsigned int>* vec)			{ ReadVector(vec); }
+	void FileStream::Read(vector<unsigned char>* vec)			{ ReadVector(vec); }
+	void FileStream::Read(vector<std::byte>* vec)				{ ReadVector(vec); }
 
-		vec->reserve(length);
-		vec->resize(length);
-
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(RHI_Vertex_PosUvNorTan) * length);
-	}
-
-	void FileStream::Read(vector<unsigned int>* vec)
+	template <class T>
+	void FileStream::ReadVector(vector<T>* vec)
 	{
 		if (!vec)
 			return;
 
-		vec->clear();
-		vec->shrink_to_fit();
-
-		auto length = ReadAs<unsigned int>();
-
-		vec->reserve(length);
-		vec->resize(length);
-
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(unsigned int) * length);
-	}
+		const auto length = ReadAs<unsigned int>();
 
-	void FileStream::Read(vector<unsigned char>* vec)
-	{
-		if (!vec)
+		// Mapped: copy straight out of the mapping, into uninitialized memory
+		if (m_mode == FileStreamMode_ReadMapped)
+		{
+			if (const auto data = reinterpret_cast<const T*>(ReadMapped(sizeof(T) * length)))
+			{
+				vec->assign(data, data + length);
+			}
+			else
+			{
+				vec->clear();
+			}
 			return;
+		}
 
-		vec->clear();
-		vec->shrink_to_fit();
-
-		auto length = ReadAs<unsigned int>();
-
-		vec->reserve(length);
+		// Streamed: the existing capacity is reused, only growth gets value initialized before it's overwritten
 		vec->resize(length);
-
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(unsigned char) * length);
+		in.read(reinterpret_cast<char*>(vec->data()), sizeof(T) * length);
 	}
 
-	void FileStream::Read(vector<std::byte>* vec)
+	const byte* FileStream::ReadMapped(const size_t size)
 	{
-		if (!vec)
-			return;
-
-		vec->clear();
-		vec->shrink_to_fit();
-
-		auto length = ReadAs<unsigned int>();
-
-		vec->reserve(length);
-		vec->resize(length);
+		if (m_map_offset + size > m_map_size)
+		{
+			LOG_ERROR("Attempted to read past the end of the file");
+			m_map_offset = m_map_size;
+			return nullptr;
+		}
 
-		in.read(reinterpret_cast<char*>(vec->data()), sizeof(std::byte) * length);
+		const auto data = m_map + m_map_offset;
+		m_map_offset += size;
+		return data;
 	}
 }
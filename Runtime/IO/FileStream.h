@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===================
 #include <vector>
 #include <fstream>
+#include <cstring>
 #include "../Math/Vector2.h"
 #include "../Math/Vector3.h"
 #include "../Math/Vector4.h"
@@ -34,22 +35,58 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace Directus
 {
 	class Entity;
+	class Threading;
 	struct RHI_Vertex_PosUvNorTan;
 
 	enum FileStreamMode
 	{
 		FileStreamMode_Read,
-		FileStreamMode_Write
+		FileStreamMode_ReadMapped,	// the file is memory mapped, arrays can be viewed without copying them (files in the mounted pack are always read like this)
+		FileStreamMode_Write,		// buffered in large blocks, the file is replaced only once everything is written
+		FileStreamMode_WriteDeferred	// kept in memory until Close(), which can be called from another thread
+	};
+
+	// Non-owning view of an array inside a memory mapped file, valid for as long as the stream is open.
+	// Arrays are packed in the file, so the data might not be aligned (fine for x86/x64).
+	template <class T>
+	class FileView
+	{
+	public:
+		FileView() = default;
+		FileView(const T* data, size_t size) : m_data(data), m_size(size) {}
+
+		const T* data() const					{ return m_data; }
+		size_t size() const						{ return m_size; }
+		bool empty() const						{ return m_size == 0; }
+		const T* begin() const					{ return m_data; }
+		const T* end() const					{ return m_data + m_size; }
+		const T& operator[](size_t i) const		{ return m_data[i]; }
+
+	private:
+		const T* m_data	= nullptr;
+		size_t m_size	= 0;
 	};
 
 	class ENGINE_CLASS FileStream
 	{
+		friend class PackFile;
+
 	public:
 		FileStream(const std::string& path, FileStreamMode mode);
 		~FileStream();
 
 		bool IsOpen() { return m_isOpen; }
 
+		// Writing modes: flushes what's left and moves the temporary file over the target (also done on destruction)
+		bool Close();
+
+		// Position (in bytes) from the start of the file
+		uint64_t GetPosition();
+		// Reading modes only
+		void Seek(uint64_t position);
+		uint64_t GetSize();
+		bool IsEnd() { return GetPosition() >= GetSize(); }
+
 		//= WRITING ==================================================
 		template <class T, class = typename std::enable_if<
 			std::is_same<T, bool>::value				||
@@ -72,7 +109,7 @@ namespace Directus
 		>::type>
 		void Write(T value)
 		{
-			out.write(reinterpret_cast<char*>(&value), sizeof(value));
+			WriteBytes(&value, sizeof(value));
 		}
 
 		void Write(const std::string& value);
@@ -81,6 +118,29 @@ namespace Directus
 		void Write(const std::vector<unsigned int>& value);
 		void Write(const std::vector<unsigned char>& value);
 		void Write(const std::vector<std::byte>& value);
+
+		// Block compressed array (see Compression.h), blocks are compressed in parallel when threading is given
+		template <class T>
+		void WriteCompressed(const std::vector<T>& value, Threading* threading = nullptr)
+		{
+			WriteRaw(Compress(value, threading));
+		}
+
+		// What WriteCompressed() writes, for when the stored size has to be known before writing it (with WriteRaw())
+		template <class T>
+		static std::vector<std::byte> Compress(const std::vector<T>& value, Threading* threading = nullptr)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be compressed");
+
+			const auto length = static_cast<unsigned int>(value.size());
+			std::vector<std::byte> compressed(sizeof(length));
+			memcpy(compressed.data(), &length, sizeof(length));
+			CompressBytes(value.data(), sizeof(T) * value.size(), threading, &compressed);
+			return compressed;
+		}
+
+		// Bytes as they are, without a length
+		void WriteRaw(const std::vector<std::byte>& value) { WriteArray(value.data(), value.size()); }
 		//===========================================================
 		
 		//= READING ===========================================
@@ -106,7 +166,7 @@ namespace Directus
 		>::type>
 		void Read(T* value)
 		{
-			in.read(reinterpret_cast<char*>(value), sizeof(T));
+			ReadBytes(value, sizeof(T));
 		}
 		void Read(std::string* value);
 		void Read(std::vector<std::string>* vec);
@@ -138,12 +198,96 @@ namespace Directus
 			Read(&value);
 			return value;
 		}
+
+		// Reads an array written by WriteCompressed(), blocks are decompressed in parallel when threading is given
+		template <class T>
+		void ReadCompressed(std::vector<T>* vec, Threading* threading = nullptr)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be compressed");
+
+			vec->resize(ReadAs<unsigned int>());
+			if (!ReadCompressedBytes(vec->data(), sizeof(T) * vec->size(), threading))
+			{
+				vec->clear();
+			}
+		}
+
+		// Reads an array (written by one of the vector writes) without copying it, only works with FileStreamMode_ReadMapped
+		template <class T>
+		FileView<T> ReadView()
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "FileView requires a trivially copyable type");
+
+			const auto length	= ReadAs<unsigned int>();
+			const auto data		= ReadMapped(sizeof(T) * length);
+			return data ? FileView<T>(reinterpret_cast<const T*>(data), length) : FileView<T>();
+		}
 		//=====================================================
 
 	private:
+		void WriteBytes(const void* source, const size_t size)
+		{
+			const auto bytes = static_cast<const std::byte*>(source);
+			m_write_buffer.insert(m_write_buffer.end(), bytes, bytes + size);
+
+			if (m_mode == FileStreamMode_Write && m_write_buffer.size() >= m_write_block_size)
+			{
+				WriteFlush();
+			}
+		}
+		void WriteArray(const void* source, size_t size);
+		void WriteFlush();
+		static void CompressBytes(const void* source, size_t size, Threading* threading, std::vector<std::byte>* destination);
+		bool ReadCompressedBytes(void* destination, size_t size, Threading* threading);
+
+		void ReadBytes(void* destination, const size_t size)
+		{
+			if (m_mode == FileStreamMode_ReadMapped)
+			{
+				if (const auto source = ReadMapped(size))
+				{
+					memcpy(destination, source, size);
+				}
+				else
+				{
+					memset(destination, 0, size);
+				}
+				return;
+			}
+
+			in.read(reinterpret_cast<char*>(destination), size);
+		}
+
+		// Reads out of the mounted pack instead, if the file is in it
+		bool OpenPacked(const std::string& path);
+
+		// Returns the next size bytes of the mapping (and moves past them), or null if there aren't as many left
+		const std::byte* ReadMapped(size_t size);
+		template <class T>
+		void ReadVector(std::vector<T>* vec);
+
 		std::ofstream out;
 		std::ifstream in;
 		FileStreamMode m_mode;
 		bool m_isOpen;
+
+		// Writing
+		std::string m_path;
+		std::string m_path_temp;
+		std::vector<std::byte> m_write_buffer;
+		uint64_t m_write_flushed = 0;
+		bool m_write_failed = false;
+		static const size_t m_write_block_size = 4 * 1024 * 1024;
+
+		// Compression, arrays are split in blocks of this (uncompressed) size
+		static constexpr size_t m_compression_block_size = 256 * 1024;
+
+		// Memory mapping
+		const std::byte* m_map	= nullptr;
+		size_t m_map_size		= 0;
+		size_t m_map_offset		= 0;
+		void* m_map_handle		= nullptr; // Windows only, the file mapping object
+		bool m_map_packed		= false; // the mapping belongs to the mounted pack
+		std::vector<std::byte> m_map_buffer; // decompressed pack entry
 	};
 }
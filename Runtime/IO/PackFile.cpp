@@ -0,0 +1,322 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "PackFile.h"
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include "FileStream.h"
+#include "../Logging/Log.h"
+#include "../FileSystem/FileSystem.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	// Layout: header, table of contents (sorted by hash), paths, entries (each aligned).
+	// Everything is read in place out of the mapping, so these have to keep their size.
+	struct PackFile::TableEntry
+	{
+		uint64_t hash;
+		uint64_t offset;
+		uint64_t size;
+		uint32_t path_offset;
+		uint32_t path_length;
+		uint32_t compressed;
+		uint32_t reserved;
+	};
+
+	namespace
+	{
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t entry_count;
+			uint32_t reserved;
+		};
+
+		const uint32_t g_magic		= 0x4B415044; // "DPAK"
+		const uint32_t g_version	= 1;
+		const size_t g_alignment	= 64;
+
+		// Compression is only kept when it saves at least this much (textures and models are already compressed)
+		const float g_compression_ratio_min = 0.875f;
+
+		// Files which are read through FileStream or XmlDocument, source assets aren't needed once imported
+		const vector<string> g_packed_extensions =
+		{
+			EXTENSION_WORLD,
+			EXTENSION_WORLD_CELL,
+			EXTENSION_MATERIAL,
+			EXTENSION_MATERIAL_BINARY,
+			EXTENSION_MODEL,
+			EXTENSION_PREFAB,
+			EXTENSION_TEXTURE,
+			EXTENSION_MESH
+		};
+
+		unique_ptr<PackFile> g_mounted;
+
+		// Paths are stored relative to the working directory, with forward slashes
+		string normalize(const string& path)
+		{
+			auto normalized = filesystem::path(path).is_absolute() ? FileSystem::GetRelativeFilePath(path) : path;
+			replace(normalized.begin(), normalized.end(), '\\', '/');
+			return filesystem::path(normalized).lexically_normal().generic_string();
+		}
+
+		// FNV-1a
+		uint64_t hash(const string& path)
+		{
+			auto hash = 14695981039346656037ull;
+			for (const auto c : path)
+			{
+				hash ^= static_cast<unsigned char>(c);
+				hash *= 1099511628211ull;
+			}
+			return hash;
+		}
+
+		bool read_file(const string& path, vector<byte>* bytes)
+		{
+			ifstream in(path, ios::in | ios::binary | ios::ate);
+			if (in.fail())
+				return false;
+
+			bytes->resize(static_cast<size_t>(in.tellg()));
+			in.seekg(0);
+			in.read(reinterpret_cast<char*>(bytes->data()), bytes->size());
+			return !in.fail();
+		}
+
+		template <class T>
+		void append(vector<byte>* bytes, const T& value)
+		{
+			const auto data = reinterpret_cast<const byte*>(&value);
+			bytes->insert(bytes->end(), data, data + sizeof(T));
+		}
+	}
+
+	PackFile::PackFile(const string& path)
+	{
+		m_file = make_unique<FileStream>(path, FileStreamMode_ReadMapped);
+		if (!m_file->IsOpen())
+			return;
+
+		m_size = static_cast<size_t>(m_file->GetSize());
+		m_data = m_file->ReadMapped(m_size);
+		if (!m_data || m_size < sizeof(Header))
+		{
+			LOGF_ERROR("\"%s\" is not a pack file", path.c_str());
+			return;
+		}
+
+		const auto header = reinterpret_cast<const Header*>(m_data);
+		if (header->magic != g_magic || header->version != g_version || sizeof(Header) + sizeof(TableEntry) * header->entry_count > m_size)
+		{
+			LOGF_ERROR("\"%s\" is not a pack file, or it's of an unsupported version", path.c_str());
+			return;
+		}
+
+		m_entries		= reinterpret_cast<const TableEntry*>(m_data + sizeof(Header));
+		m_entry_count	= header->entry_count;
+	}
+
+	PackFile::~PackFile() = default;
+
+	bool PackFile::Find(const string& path, Entry* entry) const
+	{
+		if (!IsOpen())
+			return false;
+
+		const auto path_normalized	= normalize(path);
+		const auto path_hash		= hash(path_normalized);
+		const auto end				= m_entries + m_entry_count;
+		for (auto it = lower_bound(m_entries, end, path_hash, [](const TableEntry& entry, const uint64_t hash) { return entry.hash < hash; }); it != end && it->hash == path_hash; it++)
+		{
+			// Entries were validated by Create(), but the file could have been truncated since
+			if (it->path_offset + static_cast<uint64_t>(it->path_length) > m_size || it->offset + it->size > m_size)
+				return false;
+
+			if (path_normalized.compare(0, string::npos, reinterpret_cast<const char*>(m_data + it->path_offset), it->path_length) != 0)
+				continue;
+
+			if (entry)
+			{
+				entry->data			= m_data + it->offset;
+				entry->size			= static_cast<size_t>(it->size);
+				entry->compressed	= it->compressed != 0;
+			}
+			return true;
+		}
+
+		return false;
+	}
+
+	bool PackFile::Create(const string& directory, const string& pack_path, Threading* threading)
+	{
+		struct Packed
+		{
+			string path;
+			uint64_t hash;
+			uint64_t size;
+			vector<byte> data;
+			bool compressed;
+		};
+
+		// Gather
+		vector<Packed> files;
+		uint64_t size_loose = 0;
+		error_code error;
+		for (auto it = filesystem::recursive_directory_iterator(directory, error); !error && it != filesystem::recursive_directory_iterator(); it.increment(error))
+		{
+			if (!it->is_regular_file(error))
+				continue;
+
+			const auto extension = it->path().extension().string();
+			if (find(g_packed_extensions.begin(), g_packed_extensions.end(), extension) == g_packed_extensions.end())
+				continue;
+
+			Packed file;
+			file.path = normalize(it->path().string());
+			if (!read_file(it->path().string(), &file.data))
+			{
+				LOGF_ERROR("Failed to read \"%s\"", file.path.c_str());
+				return false;
+			}
+			file.hash		= hash(file.path);
+			file.size		= file.data.size();
+			file.compressed	= false;
+			size_loose		+= file.size;
+
+			// Materials are parsed straight out of the mapping, so they are stored as is
+			if (extension != EXTENSION_MATERIAL)
+			{
+				auto compressed = FileStream::Compress(file.data, threading);
+				if (compressed.size() < file.data.size() * g_compression_ratio_min)
+				{
+					file.data		= move(compressed);
+					file.compressed	= true;
+				}
+			}
+
+			files.emplace_back(move(file));
+		}
+		if (error)
+		{
+			LOGF_ERROR("Failed to enumerate \"%s\", %s", directory.c_str(), error.message().c_str());
+			return false;
+		}
+
+		sort(files.begin(), files.end(), [](const Packed& a, const Packed& b) { return a.hash < b.hash; });
+
+		// Lay out
+		vector<byte> table;
+		vector<byte> paths;
+		const auto paths_offset	= sizeof(Header) + sizeof(TableEntry) * files.size();
+		auto offset				= paths_offset;
+		for (const auto& file : files)
+		{
+			offset += file.path.size();
+		}
+
+		for (const auto& file : files)
+		{
+			offset = (offset + g_alignment - 1) / g_alignment * g_alignment;
+
+			TableEntry entry	= {};
+			entry.hash			= file.hash;
+			entry.offset		= offset;
+			entry.size			= file.data.size();
+			entry.path_offset	= static_cast<uint32_t>(paths_offset + paths.size());
+			entry.path_length	= static_cast<uint32_t>(file.path.size());
+			entry.compressed	= file.compressed ? 1 : 0;
+			append(&table, entry);
+
+			paths.insert(paths.end(), reinterpret_cast<const byte*>(file.path.data()), reinterpret_cast<const byte*>(file.path.data()) + file.path.size());
+			offset += file.data.size();
+		}
+
+		// Write
+		{
+			auto file = make_unique<FileStream>(pack_path, FileStreamMode_Write);
+			if (!file->IsOpen())
+				return false;
+
+			Header header		= {};
+			header.magic		= g_magic;
+			header.version		= g_version;
+			header.entry_count	= static_cast<uint32_t>(files.size());
+
+			vector<byte> bytes;
+			append(&bytes, header);
+			file->WriteRaw(bytes);
+			file->WriteRaw(table);
+			file->WriteRaw(paths);
+
+			for (const auto& packed : files)
+			{
+				const auto padding = static_cast<size_t>((g_alignment - file->GetPosition() % g_alignment) % g_alignment);
+				file->WriteRaw(vector<byte>(padding));
+				file->WriteRaw(packed.data);
+			}
+
+			if (!file->Close())
+				return false;
+		}
+
+		LOGF_INFO("Packed %d files from \"%s\" into \"%s\", %.1f MB -> %.1f MB", static_cast<int>(files.size()), directory.c_str(), pack_path.c_str(),
+			size_loose / (1024.0f * 1024.0f), offset / (1024.0f * 1024.0f));
+
+		return true;
+	}
+
+	bool PackFile::Mount(const string& path)
+	{
+		Unmount();
+
+		auto pack = make_unique<PackFile>(path);
+		if (!pack->IsOpen())
+		{
+			LOGF_ERROR("Failed to mount \"%s\"", path.c_str());
+			return false;
+		}
+
+		LOGF_INFO("Mounted \"%s\", %d files", path.c_str(), static_cast<int>(pack->GetEntryCount()));
+		g_mounted = move(pack);
+		return true;
+	}
+
+	void PackFile::Unmount()
+	{
+		g_mounted.reset();
+	}
+
+	const PackFile* PackFile::GetMounted()
+	{
+		return g_mounted.get();
+	}
+}
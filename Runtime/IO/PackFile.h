@@ -0,0 +1,77 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <string>
+#include <vector>
+#include <memory>
+#include "../Core/EngineDefs.h"
+//=============================
+
+// Mounted on startup when it's in the working directory
+static const char* PACK_FILE_NAME = "Data.pak";
+
+namespace Directus
+{
+	class FileStream;
+	class Threading;
+
+	// Shipped assets in a single memory mapped archive. The table of contents is a hashed path table which is
+	// searched in place, so mounting doesn't parse anything. Entries are aligned and can be block compressed.
+	class ENGINE_CLASS PackFile
+	{
+	public:
+		// A file inside the pack, data points into the mapping
+		struct Entry
+		{
+			const std::byte* data	= nullptr;
+			size_t size				= 0;
+			bool compressed			= false; // written by FileStream::WriteCompressed()
+		};
+
+		PackFile(const std::string& path);
+		~PackFile();
+
+		bool IsOpen() const { return m_entries != nullptr; }
+		bool Find(const std::string& path, Entry* entry) const;
+		unsigned int GetEntryCount() const { return m_entry_count; }
+
+		// Packs the engine files of a directory (paths are stored relative to the working directory)
+		static bool Create(const std::string& directory, const std::string& pack_path, Threading* threading = nullptr);
+
+		// FileStream and FileSystem look inside the mounted pack before the disk. Files in the pack win over
+		// loose ones, mount it before anything is loaded and don't unmount it while files are being read.
+		static bool Mount(const std::string& path);
+		static void Unmount();
+		static const PackFile* GetMounted();
+
+	private:
+		struct TableEntry;
+
+		std::unique_ptr<FileStream> m_file;
+		const std::byte* m_data			= nullptr;
+		size_t m_size					= 0;
+		const TableEntry* m_entries		= nullptr;
+		unsigned int m_entry_count		= 0;
+	};
+}
@@ -19,7 +19,7 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ========================
+//= INCLUDES =========================
 #include "XmlDocument.h"
 #include "pugixml.hpp"
 #include "../Logging/Log.h"
@@ -27,7 +27,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Math/Vector3.h"
 #include "../Math/Vector4.h"
 #include "../FileSystem/FileSystem.h"
-//===================================
+#include "../FileSystem/FileWatcher.h"
+#include "PackFile.h"
+//====================================
 
 //= NAMESPACES ================
 using namespace std;
@@ -257,7 +259,13 @@ namespace Directus
 	bool XmlDocument::Load(const string& filePath)
 	{
 		m_document = make_unique<xml_document>();
-		xml_parse_result result = m_document->load_file(filePath.c_str());
+
+		// Packed documents are parsed out of the pack's mapping, the packer doesn't compress them
+		PackFile::Entry packed;
+		const auto pack = PackFile::GetMounted();
+		xml_parse_result result = (pack && pack->Find(filePath, &packed) && !packed.compressed) ?
+			m_document->load_buffer(packed.data, packed.size) :
+			m_document->load_file(filePath.c_str());
 
 		if (result.status != status_ok)
 		{
@@ -289,6 +297,7 @@ namespace Directus
 			FileSystem::DeleteFile_(filePath);
 		}
 
+		FileWatcher::IgnoreWrite(filePath);
 		return m_document->save_file(filePath.c_str());
 	}
 
@@ -21,13 +21,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==============================
 #include "Ray.h"
-#include <algorithm>
 #include "RayHit.h"
 #include "BoundingBox.h"
+#include "../Core/Context.h"
 #include "../World/World.h"
-#include "../World/Entity.h"
-#include "../World/Components/Renderable.h"
-#include "../World/Components/Skybox.h"
 //=========================================
 
 //= NAMESPACES =====
@@ -43,38 +40,10 @@ namespace Directus::Math
 		m_direction = (end - start).Normalized();
 	}
 
-	vector<RayHit> Ray::Trace(Context* context) const
+	vector<RayHit> Ray::Trace(Context* context, const uint32_t tags) const
 	{
-		// Find all the entities that the ray hits
-		vector<RayHit> hits;
-		const auto& entities = context->GetSubsystem<World>()->Entities_GetAll();
-		for (const auto& entity : entities)
-		{
-			// Make sure there entity has a mesh and exclude the SkyBox
-			if (!entity->HasComponent<Renderable>() || entity->HasComponent<Skybox>())
-				continue;
-
-			// Get bounding box
-			auto aabb = entity->GetComponent<Renderable>()->GeometryAabb();
-
-			// Compute hit distance
-			auto hit_distance = HitDistance(aabb);
-
-			// Don't store hit data if there was no hit
-			if (hit_distance == INFINITY)
-				continue;
-
-			auto inside	= (hit_distance == 0.0f);
-			hits.emplace_back(entity, hit_distance, inside);
-		}
-
-		// Sort by distance (ascending)
-		sort(hits.begin(), hits.end(), [](const RayHit& a, const RayHit& b)
-		{
-			return a.m_distance < b.m_distance;
-		});
-
-		return hits;
+		// The world's spatial index only visits the entities near the ray
+		return context->GetSubsystem<World>()->Raycast(*this, tags);
 	}
 
 	float Ray::HitDistance(const BoundingBox& box) const
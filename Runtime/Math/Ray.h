@@ -43,8 +43,8 @@ namespace Directus
 			Ray(const Vector3& start, const Vector3& end);
 			~Ray() = default;
 
-			// Traces a ray against all entities in the world, returns all hits in a vector.
-			std::vector<RayHit> Trace(Context* context) const;
+			// Traces a ray against all entities in the world (which have all of the tags), returns all hits in a vector.
+			std::vector<RayHit> Trace(Context* context, uint32_t tags = 0) const;
 
 			// Returns hit distance to a bounding box, or infinity if there is no hit.
 			float HitDistance(const BoundingBox& box) const;
@@ -214,6 +214,14 @@ namespace Directus
 		const auto materials	= m_resource_manager->GetResourceCountByType(Resource_Material);
 		const auto shaders		= m_resource_manager->GetResourceCountByType(Resource_Shader);
 
+		// Resident memory against its budget, in MB
+		auto to_string_residency = [this](const Resource_Type type)
+		{
+			const auto resident	= m_resource_manager->GetMemoryResident(type) / 1024 / 1024;
+			const auto budget	= m_resource_manager->GetMemoryBudget(type) / 1024 / 1024;
+			return to_string(resident) + (budget != 0 ? " / " + to_string(budget) : "") + " MB";
+		};
+
 		auto to_string_precision = [](float value, unsigned int decimals)
 		{
 			stringstream out;
@@ -236,6 +244,8 @@ namespace Directus
 			"Textures:\t\t\t\t\t\t"				+ to_string(textures) + "\n"
 			"Materials:\t\t\t\t\t\t"			+ to_string(materials) + "\n"
 			"Shaders:\t\t\t\t\t\t"				+ to_string(shaders) + "\n"
+			"Texture memory:\t\t\t\t\t"		+ to_string_residency(Resource_Texture) + "\n"
+			"Model memory:\t\t\t\t\t"			+ to_string_residency(Resource_Model) + "\n"
 
 			// RHI
 			"RHI Draw calls:\t\t\t\t\t"			+ to_string(m_rhi_draw_calls) + "\n"
@@ -19,13 +19,15 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =========================
+//= INCLUDES ==============================
 #include "RHI_Texture.h"
 #include "RHI_Device.h"
 #include "../IO/FileStream.h"
 #include "../Rendering/Renderer.h"
 #include "../Resource/ResourceCache.h"
-//====================================
+#include "../Threading/Threading.h"
+#include "../Resource/Import/ImportCache.h"
+//=========================================
 
 //= NAMESPACES =====
 using namespace std;
@@ -33,6 +35,106 @@ using namespace std;
 
 namespace Directus
 {
+	namespace
+	{
+		// Version 2 layout: header, properties, mip table, mips.
+		// Version 1 files (no header) start with the mips and end with the properties.
+		const unsigned int g_texture_magic		= 0x52545854; // "TXTR"
+		const unsigned int g_texture_version	= 2;
+
+		enum Texture_Compression : unsigned int
+		{
+			Texture_Compression_None,
+			Texture_Compression_Lz	// FileStream::WriteCompressed()
+		};
+
+		// Where a mip lives in the file, the offset points to its (length prefixed) bytes
+		struct mip_entry
+		{
+			uint64_t offset				= 0;
+			uint64_t size				= 0; // stored size
+			unsigned int compression	= Texture_Compression_None;
+		};
+		const uint64_t g_mip_entry_size = sizeof(uint64_t) * 2 + sizeof(unsigned int);
+
+		// Reads the properties into the texture and returns where each mip is, without reading any of them
+		bool read_header(FileStream* file, RHI_Texture* texture, vector<mip_entry>* mips)
+		{
+			const auto magic = file->ReadAs<unsigned int>();
+
+			if (magic != g_texture_magic)
+			{
+				// Version 1, the first value is the mip count, the mips have to be walked to reach the properties
+				mips->resize(magic);
+				for (auto& mip : *mips)
+				{
+					mip.offset	= file->GetPosition();
+					mip.size	= file->ReadAs<unsigned int>();
+					file->Seek(mip.offset + sizeof(unsigned int) + mip.size);
+				}
+
+				texture->SetBpp(file->ReadAs<unsigned int>());
+				texture->SetWidth(file->ReadAs<unsigned int>());
+				texture->SetHeight(file->ReadAs<unsigned int>());
+				texture->SetChannels(file->ReadAs<unsigned int>());
+				texture->SetGrayscale(file->ReadAs<bool>());
+				texture->SetTransparency(file->ReadAs<bool>());
+				texture->SetResourceID(file->ReadAs<unsigned int>());
+				texture->SetResourceName(file->ReadAs<string>());
+				texture->SetResourceFilePath(file->ReadAs<string>());
+				return true;
+			}
+
+			const auto version = file->ReadAs<unsigned int>();
+			if (version != g_texture_version)
+			{
+				LOGF_ERROR("Unsupported texture version %d.", version);
+				return false;
+			}
+
+			texture->SetWidth(file->ReadAs<unsigned int>());
+			texture->SetHeight(file->ReadAs<unsigned int>());
+			texture->SetChannels(file->ReadAs<unsigned int>());
+			texture->SetBpp(file->ReadAs<unsigned int>());
+			texture->SetBpc(file->ReadAs<unsigned int>());
+			texture->SetFormat(static_cast<RHI_Format>(file->ReadAs<unsigned int>()));
+			texture->SetGrayscale(file->ReadAs<bool>());
+			texture->SetTransparency(file->ReadAs<bool>());
+			texture->SetResourceID(file->ReadAs<unsigned int>());
+			texture->SetResourceName(file->ReadAs<string>());
+			texture->SetResourceFilePath(file->ReadAs<string>());
+
+			mips->resize(file->ReadAs<unsigned int>());
+			for (auto& mip : *mips)
+			{
+				file->Read(&mip.offset);
+				file->Read(&mip.size);
+				file->Read(&mip.compression);
+			}
+
+			return true;
+		}
+
+		bool read_mip(FileStream* file, const mip_entry& mip, mip_level* bytes, Threading* threading)
+		{
+			file->Seek(mip.offset);
+
+			if (mip.compression == Texture_Compression_None)
+			{
+				file->Read(bytes);
+				return true;
+			}
+
+			if (mip.compression == Texture_Compression_Lz)
+			{
+				file->ReadCompressed(bytes, threading);
+				return !bytes->empty();
+			}
+
+			return false;
+		}
+	}
+
 	RHI_Texture::RHI_Texture(Context* context) : IResource(context, Resource_Texture)
 	{
 		m_format		= Format_R8G8B8A8_UNORM;
@@ -57,6 +159,7 @@ namespace Directus
 
 		m_mip_chain.clear();
 		m_mip_chain.shrink_to_fit();
+		m_import_source.clear();
 		SetLoadState(LoadState_Started);
 
 		// Load from disk
@@ -92,8 +195,8 @@ namespace Directus
 			ShaderResource_Create2D(m_width, m_height, m_channels, m_format, m_mip_chain) :
 			ShaderResource_Create2D(m_width, m_height, m_channels, m_format, m_mip_chain.front(), m_needs_mip_chain);
 
-		// Only clear texture bytes if that's an engine texture, if not, they are not serialized yet.
-		if (FileSystem::IsEngineTextureFile(filePath)) { ClearTextureBytes(); }
+		// Only clear texture bytes if they came from an engine texture, if they were imported, they are not serialized yet.
+		if (m_import_source.empty()) { ClearTextureBytes(); }
 
 		if (!srvCreated) 
 		{ 
@@ -107,6 +210,18 @@ namespace Directus
 	}
 	//=====================================================================================
 
+	unsigned int RHI_Texture::GetMemoryUsage()
+	{
+		// The shader resource (estimated when it's created), plus any bytes still kept around
+		auto size = m_memory_usage;
+		for (const auto& mip : m_mip_chain)
+		{
+			size += static_cast<unsigned int>(mip.size());
+		}
+
+		return size;
+	}
+
 	mip_level* RHI_Texture::Data_GetMipLevel(unsigned int index)
 	{
 		if (index >= m_mip_chain.size())
@@ -129,40 +244,86 @@ namespace Directus
 		m_mip_chain.shrink_to_fit();
 	}
 
-	void RHI_Texture::GetTextureBytes(vector<vector<std::byte>>* texture_bytes)
+	void RHI_Texture::GetTextureBytes(vector<mip_level>* texture_bytes)
 	{
 		if (!m_mip_chain.empty())
 		{
-			texture_bytes = &m_mip_chain;
+			if (texture_bytes != &m_mip_chain)
+			{
+				*texture_bytes = m_mip_chain;
+			}
 			return;
 		}
 
-		auto file = make_unique<FileStream>(GetResourceFilePath(), FileStreamMode_Read);
+		auto file = make_unique<FileStream>(GetResourceFilePath(), FileStreamMode_ReadMapped);
 		if (!file->IsOpen())
 			return;
 
-		unsigned int mipCount = file->ReadAs<unsigned int>();
-		for (unsigned int i = 0; i < mipCount; i++)
+		vector<mip_entry> mips;
+		if (!read_header(file.get(), this, &mips))
+			return;
+
+		texture_bytes->resize(mips.size());
+		for (size_t i = 0; i < mips.size(); i++)
 		{
-			texture_bytes->emplace_back(vector<std::byte>());
-			file->Read(&m_mip_chain[i]);
+			read_mip(file.get(), mips[i], &(*texture_bytes)[i], m_context->GetSubsystem<Threading>().get());
 		}
 	}
 
+	void RHI_Texture::Swap(RHI_Texture& other)
+	{
+		swap(m_bpp,				other.m_bpp);
+		swap(m_bpc,				other.m_bpc);
+		swap(m_width,			other.m_width);
+		swap(m_height,			other.m_height);
+		swap(m_channels,		other.m_channels);
+		swap(m_is_grayscale,	other.m_is_grayscale);
+		swap(m_is_transparent,	other.m_is_transparent);
+		swap(m_needs_mip_chain,	other.m_needs_mip_chain);
+		swap(m_format,			other.m_format);
+		swap(m_mip_chain,		other.m_mip_chain);
+		swap(m_shader_resource,	other.m_shader_resource);
+		swap(m_memory_usage,	other.m_memory_usage);
+	}
+
 	bool RHI_Texture::LoadFromForeignFormat(const string& file_path)
 	{
+		ImageImporter* imageImp		= m_context->GetSubsystem<ResourceCache>()->GetImageImporter();
+		const auto texture_path		= FileSystem::GetFilePathWithoutExtension(file_path) + EXTENSION_TEXTURE;
+		const auto import_settings	= imageImp->GetImportSettings(this);
+
+		// Imported before and unchanged since, load what that import produced instead
+		if (ImportCache::IsUpToDate(file_path, import_settings, texture_path) && Deserialize(texture_path))
+			return true;
+
 		// Load texture
-		ImageImporter* imageImp = m_context->GetSubsystem<ResourceCache>()->GetImageImporter();	
 		if (!imageImp->Load(file_path, this))
 			return false;
 
 		// Change texture extension to an engine texture
-		SetResourceFilePath(FileSystem::GetFilePathWithoutExtension(file_path) + EXTENSION_TEXTURE);
+		SetResourceFilePath(texture_path);
 		SetResourceName(FileSystem::GetFileNameNoExtensionFromFilePath(GetResourceFilePath()));
 
+		// Recorded in the import cache once saved
+		m_import_source		= file_path;
+		m_import_settings	= import_settings;
+
 		return true;
 	}
 
+	bool RHI_Texture::LoadMetadata(const string& file_path)
+	{
+		if (!FileSystem::IsEngineTextureFile(file_path))
+			return false;
+
+		auto file = make_unique<FileStream>(file_path, FileStreamMode_ReadMapped);
+		if (!file->IsOpen())
+			return false;
+
+		vector<mip_entry> mips;
+		return read_header(file.get(), this, &mips);
+	}
+
 	bool RHI_Texture::Serialize(const string& file_path)
 	{
 		// If the texture bits has been cleared, load it again
@@ -174,54 +335,104 @@ namespace Directus
 		if (!file->IsOpen())
 			return false;
 
-		// Write texture bits
-		file->Write((unsigned int)m_mip_chain.size());
-		for (auto& mip : m_mip_chain)
-		{
-			file->Write(mip);
-		}
+		// Header
+		file->Write(g_texture_magic);
+		file->Write(g_texture_version);
 
-		// Write properties
-		file->Write(m_bpp);
+		// Properties
 		file->Write(m_width);
 		file->Write(m_height);
 		file->Write(m_channels);
+		file->Write(m_bpp);
+		file->Write(m_bpc);
+		file->Write(static_cast<unsigned int>(m_format));
 		file->Write(m_is_grayscale);
 		file->Write(m_is_transparent);
 		file->Write(GetResourceId());
 		file->Write(GetResourceName());
 		file->Write(GetResourceFilePath());
 
+		// Mips, compressed in memory first since the table ahead of them needs their sizes
+		const auto compression = Settings::Get().GetAssetCompression() ? Texture_Compression_Lz : Texture_Compression_None;
+		vector<mip_level> mips_compressed(compression == Texture_Compression_Lz ? m_mip_chain.size() : 0);
+		for (size_t i = 0; i < mips_compressed.size(); i++)
+		{
+			mips_compressed[i] = FileStream::Compress(m_mip_chain[i], m_context->GetSubsystem<Threading>().get());
+		}
+		const auto& mips = compression == Texture_Compression_Lz ? mips_compressed : m_mip_chain;
+
+		// Mip table, the mips follow it back to back
+		file->Write(static_cast<unsigned int>(mips.size()));
+		auto offset = file->GetPosition() + mips.size() * g_mip_entry_size;
+		for (const auto& mip : mips)
+		{
+			file->Write(offset);
+			file->Write(static_cast<uint64_t>(mip.size()));
+			file->Write(static_cast<unsigned int>(compression));
+			offset += compression == Texture_Compression_Lz ? mip.size() : sizeof(unsigned int) + mip.size();
+		}
+
+		for (const auto& mip : mips)
+		{
+			if (compression == Texture_Compression_Lz)
+			{
+				file->WriteRaw(mip);
+			}
+			else
+			{
+				file->Write(mip);
+			}
+		}
+
 		ClearTextureBytes();
 
+		if (!file->Close())
+			return false;
+
+		if (!m_import_source.empty())
+		{
+			ImportCache::Store(m_import_source, m_import_settings, file_path);
+			m_import_source.clear();
+		}
+
 		return true;
 	}
 
-	bool RHI_Texture::Deserialize(const string& file_path)
+	bool RHI_Texture::Deserialize(const string& file_path, const unsigned int mip_start, const unsigned int mip_count)
 	{
-		auto file = make_unique<FileStream>(file_path, FileStreamMode_Read);
+		auto file = make_unique<FileStream>(file_path, FileStreamMode_ReadMapped);
 		if (!file->IsOpen())
 			return false;
 
-		// Read texture bits
 		ClearTextureBytes();
-		m_mip_chain.resize(file->ReadAs<unsigned int>());
-		for (auto& mip : m_mip_chain)
+
+		vector<mip_entry> mips;
+		if (!read_header(file.get(), this, &mips))
+			return false;
+
+		if (mip_start >= mips.size())
+		{
+			LOGF_ERROR("\"%s\" has %d mips, can't start reading from mip %d.", file_path.c_str(), static_cast<int>(mips.size()), mip_start);
+			return false;
+		}
+
+		// Only the requested mips are read, the rest of the file is never touched
+		const auto mip_end = mip_count == 0 ? mips.size() : min(mips.size(), static_cast<size_t>(mip_start) + mip_count);
+		m_mip_chain.resize(mip_end - mip_start);
+		const auto threading = m_context->GetSubsystem<Threading>().get();
+		for (size_t i = 0; i < m_mip_chain.size(); i++)
 		{
-			file->Read(&mip);
+			if (!read_mip(file.get(), mips[mip_start + i], &m_mip_chain[i], threading))
+			{
+				LOGF_ERROR("Failed to read mip %d of \"%s\".", static_cast<int>(mip_start + i), file_path.c_str());
+				ClearTextureBytes();
+				return false;
+			}
 		}
 
-		// Read properties
-		file->Read(&m_bpp);
-		file->Read(&m_width);
-		file->Read(&m_height);
-		file->Read(&m_channels);
-		file->Read(&m_is_grayscale);
-		file->Read(&m_is_transparent);
-		SetResourceID(file->ReadAs<unsigned int>());
-		SetResourceName(file->ReadAs<string>());
-		SetResourceFilePath(file->ReadAs<string>());
+		m_width		= max(m_width >> mip_start, 1u);
+		m_height	= max(m_height >> mip_start, 1u);
 
 		return true;
 	}
-}
+}
\ No newline at end of file
@@ -45,6 +45,9 @@ namespace Directus
 		//= IResource ===========================================
 		bool SaveToFile(const std::string& file_path) override;
 		bool LoadFromFile(const std::string& file_path) override;
+		// Reads the properties of an engine texture without touching its mips
+		bool LoadMetadata(const std::string& file_path) override;
+		unsigned int GetMemoryUsage() override;
 		//=======================================================
 
 		//= GRAPHICS API  ===================================================================================================================================================================
@@ -99,11 +102,16 @@ namespace Directus
 		void GetTextureBytes(std::vector<mip_level>* texture_bytes);
 		//==========================================================
 
+		// Exchanges contents (properties, bytes and shader resource) with another texture, e.g. a newly imported version of it
+		void Swap(RHI_Texture& other);
+
 	protected:
-		//= NATIVE TEXTURE HANDLING (BINARY) ==========
+		//= NATIVE TEXTURE HANDLING (BINARY) ===================================================================================
 		bool Serialize(const std::string& file_path);
-		bool Deserialize(const std::string& file_path);
-		//=============================================
+		// Reads mips [mip_start, mip_start + mip_count), a count of 0 reads the rest of the chain.
+		// Width and height become those of the first mip read.
+		bool Deserialize(const std::string& file_path, unsigned int mip_start = 0, unsigned int mip_count = 0);
+		//======================================================================================================================
 
 		bool LoadFromForeignFormat(const std::string& file_path);
 		
@@ -120,6 +128,10 @@ namespace Directus
 		std::vector<mip_level> m_mip_chain;
 		//=================================
 
+		// Set after an import, until the result is saved (and recorded in the import cache)
+		std::string m_import_source;
+		std::string m_import_settings;
+
 		// D3D11
 		std::shared_ptr<RHI_Device> m_rhi_device;
 		void* m_shader_resource		= nullptr;
@@ -62,6 +62,7 @@ namespace Directus
 
 		// Variation cache
 		static std::shared_ptr<ShaderVariation> GetMatchingShader(unsigned long flags);
+		static void ClearVariations() { m_variations.clear(); }
 
 	private:
 		void AddDefinesBasedOnMaterial();
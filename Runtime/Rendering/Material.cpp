@@ -21,11 +21,15 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =========================
 #include "Material.h"
+#include <filesystem>
 #include "Renderer.h"
 #include "Deferred/ShaderVariation.h"
 #include "../Resource/ResourceCache.h"
 #include "../IO/XmlDocument.h"
+#include "../IO/FileStream.h"
+#include "../IO/PackFile.h"
 #include "../RHI/RHI_ConstantBuffer.h"
+#include "../Core/EventSystem.h"
 //====================================
 
 //= NAMESPACES ================
@@ -35,6 +39,42 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace
+	{
+		const unsigned int g_material_magic		= 0x4C54414D; // "MATL"
+		const unsigned int g_material_version	= 1;
+
+		// Everything but the name, the path and the textures, read and written in one go
+		struct material_binary
+		{
+			uint64_t source_size;	// of the .mat it was written from, to tell if it was edited since
+			int64_t source_time;
+			uint32_t cull_mode;
+			uint32_t shading_mode;
+			Vector4 color_albedo;
+			float roughness_multiplier;
+			float metallic_multiplier;
+			float normal_multiplier;
+			float height_multiplier;
+			Vector2 uv_tiling;
+			Vector2 uv_offset;
+			uint32_t is_editable;
+			uint32_t texture_count;
+		};
+
+		// Size and modification time, a cheap way to tell that a file hasn't been touched
+		bool file_stamp(const string& path, uint64_t* size, int64_t* time)
+		{
+			error_code error;
+			*size = static_cast<uint64_t>(filesystem::file_size(path, error));
+			if (error)
+				return false;
+
+			*time = static_cast<int64_t>(filesystem::last_write_time(path, error).time_since_epoch().count());
+			return !error;
+		}
+	}
+
 	Material::Material(Context* context) : IResource(context, Resource_Material)
 	{
 		// Material
@@ -65,10 +105,19 @@ namespace Directus
 		// Make sure the path is relative
 		SetResourceFilePath(FileSystem::GetRelativeFilePath(file_path));
 
+		const auto file_path_binary = FileSystem::GetFilePathWithoutExtension(GetResourceFilePath()) + EXTENSION_MATERIAL_BINARY;
+		if (LoadFromFileBinary(file_path_binary))
+		{
+			AcquireShader();
+			return true;
+		}
+
 		auto xml = make_unique<XmlDocument>();
 		if (!xml->Load(GetResourceFilePath()))
 			return false;
 
+		const auto file_path_xml = GetResourceFilePath();
+
 		SetResourceName(xml->GetAttributeAs<string>("Material",	"Name"));
 		SetResourceFilePath(xml->GetAttributeAs<string>("Material",	"Path"));
 		xml->GetAttribute("Material", "Roughness_Multiplier",	&m_roughness_multiplier);
@@ -78,7 +127,10 @@ namespace Directus
 		xml->GetAttribute("Material", "IsEditable",				&m_is_editable);
 		xml->GetAttribute("Material", "Cull_Mode",				(unsigned int*)&m_cull_mode);
 		xml->GetAttribute("Material", "Shading_Mode",			(unsigned int*)&m_shading_mode);
-		xml->GetAttribute("Material", "Color",					&m_color_albedo);
+		// Through the setter, the renderer has to know if it turned transparent (it might be drawn already, while loading)
+		auto color_albedo = m_color_albedo;
+		xml->GetAttribute("Material", "Color",					&color_albedo);
+		SetColorAlbedo(color_albedo);
 		xml->GetAttribute("Material", "UV_Tiling",				&m_uv_tiling);
 		xml->GetAttribute("Material", "UV_Offset",				&m_uv_offset);
 
@@ -89,19 +141,17 @@ namespace Directus
 			const auto tex_type	= static_cast<TextureType>(xml->GetAttributeAs<unsigned int>(node_name, "Texture_Type"));
 			auto tex_name		= xml->GetAttributeAs<string>(node_name, "Texture_Name");
 			auto tex_path		= xml->GetAttributeAs<string>(node_name, "Texture_Path");
-
-			// If the texture happens to be loaded, get a reference to it
-			auto texture = m_context->GetSubsystem<ResourceCache>()->GetByName<RHI_Texture>(tex_name);
-			// If there is not texture (it's not loaded yet), load it
-			if (!texture)
-			{
-				texture = m_context->GetSubsystem<ResourceCache>()->Load<RHI_Texture>(tex_path);
-			}
-			SetTextureSlot(tex_type, texture);
+			TextureSlotLoad(tex_type, tex_name, tex_path);
 		}
 
 		AcquireShader();
 
+		// Missing or out of date, the next load won't have to parse the xml (shipped files come from the pack, which isn't written to)
+		if (!PackFile::GetMounted())
+		{
+			SaveToFileBinary(file_path_binary, file_path_xml);
+		}
+
 		return true;
 	}
 
@@ -144,7 +194,109 @@ namespace Directus
 			i++;
 		}
 
-		return xml->Save(GetResourceFilePath());
+		if (!xml->Save(GetResourceFilePath()))
+			return false;
+
+		return SaveToFileBinary(FileSystem::GetFilePathWithoutExtension(GetResourceFilePath()) + EXTENSION_MATERIAL_BINARY, GetResourceFilePath());
+	}
+
+	bool Material::LoadFromFileBinary(const string& file_path)
+	{
+		if (!FileSystem::FileExists(file_path))
+			return false;
+
+		auto file = make_unique<FileStream>(file_path, FileStreamMode_ReadMapped);
+		if (!file->IsOpen() || file->ReadAs<unsigned int>() != g_material_magic || file->ReadAs<unsigned int>() != g_material_version)
+			return false;
+
+		material_binary binary;
+		const auto bytes = file->ReadView<byte>();
+		if (bytes.size() != sizeof(binary))
+			return false;
+		memcpy(&binary, bytes.data(), sizeof(binary));
+
+		// The .mat next to it was edited since (a pack is consistent, its files are never out of date).
+		// That's the file the stamp was taken from, the embedded path can point elsewhere if the files were moved.
+		const auto name			= file->ReadAs<string>();
+		const auto path			= file->ReadAs<string>();
+		const auto path_source	= FileSystem::GetFilePathWithoutExtension(file_path) + EXTENSION_MATERIAL;
+		uint64_t source_size;
+		int64_t source_time;
+		if (!PackFile::GetMounted() && file_stamp(path_source, &source_size, &source_time) && (source_size != binary.source_size || source_time != binary.source_time))
+			return false;
+
+		SetResourceName(name);
+		SetResourceFilePath(path);
+		m_cull_mode				= static_cast<RHI_Cull_Mode>(binary.cull_mode);
+		m_shading_mode			= static_cast<ShadingMode>(binary.shading_mode);
+		m_roughness_multiplier	= binary.roughness_multiplier;
+		m_metallic_multiplier	= binary.metallic_multiplier;
+		m_normal_multiplier		= binary.normal_multiplier;
+		m_height_multiplier		= binary.height_multiplier;
+		m_uv_tiling				= binary.uv_tiling;
+		m_uv_offset				= binary.uv_offset;
+		m_is_editable			= binary.is_editable != 0;
+		SetColorAlbedo(binary.color_albedo);
+
+		for (uint32_t i = 0; i < binary.texture_count; i++)
+		{
+			const auto type			= static_cast<TextureType>(file->ReadAs<unsigned int>());
+			const auto texture_name	= file->ReadAs<string>();
+			const auto texture_path	= file->ReadAs<string>();
+			TextureSlotLoad(type, texture_name, texture_path);
+		}
+
+		return true;
+	}
+
+	bool Material::SaveToFileBinary(const string& file_path, const string& file_path_xml)
+	{
+		material_binary binary		= {};
+		binary.cull_mode			= static_cast<uint32_t>(m_cull_mode);
+		binary.shading_mode			= static_cast<uint32_t>(m_shading_mode);
+		binary.color_albedo			= m_color_albedo;
+		binary.roughness_multiplier	= m_roughness_multiplier;
+		binary.metallic_multiplier	= m_metallic_multiplier;
+		binary.normal_multiplier	= m_normal_multiplier;
+		binary.height_multiplier	= m_height_multiplier;
+		binary.uv_tiling			= m_uv_tiling;
+		binary.uv_offset			= m_uv_offset;
+		binary.is_editable			= m_is_editable ? 1 : 0;
+		binary.texture_count		= static_cast<uint32_t>(m_texture_slots.size());
+		file_stamp(file_path_xml, &binary.source_size, &binary.source_time);
+
+		vector<byte> bytes(sizeof(binary));
+		memcpy(bytes.data(), &binary, sizeof(binary));
+
+		auto file = make_unique<FileStream>(file_path, FileStreamMode_Write);
+		if (!file->IsOpen())
+			return false;
+
+		file->Write(g_material_magic);
+		file->Write(g_material_version);
+		file->Write(bytes);
+		file->Write(GetResourceName());
+		file->Write(GetResourceFilePath());
+		for (const auto& texture_slot : m_texture_slots)
+		{
+			file->Write(static_cast<unsigned int>(texture_slot.type));
+			file->Write(texture_slot.ptr ? texture_slot.ptr->GetResourceName() : NOT_ASSIGNED);
+			file->Write(texture_slot.ptr ? texture_slot.ptr->GetResourceFilePath() : NOT_ASSIGNED);
+		}
+
+		return file->Close();
+	}
+
+	void Material::TextureSlotLoad(const TextureType type, const string& texture_name, const string& texture_path)
+	{
+		// If the texture happens to be loaded, get a reference to it
+		auto texture = m_context->GetSubsystem<ResourceCache>()->GetByName<RHI_Texture>(texture_name);
+		// If there is not texture (it's not loaded yet), load it on the job system, its properties are known right away
+		if (!texture)
+		{
+			texture = m_context->GetSubsystem<ResourceCache>()->LoadAsync<RHI_Texture>(texture_path);
+		}
+		SetTextureSlot(type, texture);
 	}
 
 	const TextureSlot& Material::GetTextureSlotByType(const TextureType type)
@@ -320,6 +472,19 @@ namespace Directus
 		}
 	}
 
+	void Material::SetColorAlbedo(const Vector4& color)
+	{
+		// The renderer keeps opaque and transparent objects in separate lists
+		const auto transparency_changed = (m_color_albedo.w < 1.0f) != (color.w < 1.0f);
+
+		m_color_albedo = color;
+
+		if (transparency_changed)
+		{
+			FIRE_EVENT(Event_Material_Transparency);
+		}
+	}
+
 	void Material::TextureBasedMultiplierAdjustment()
 	{
 		if (HasTexture(TextureType_Roughness))
@@ -90,6 +90,7 @@ namespace Directus
 		bool HasTexture(const std::string& path);
 		std::string GetTexturePathByType(TextureType type);
 		std::vector<std::string> GetTexturePaths();
+		const std::vector<TextureSlot>& GetTextureSlots() const { return m_texture_slots; }
 		//=================================================================================
 
 		//= SHADER ====================================================================
@@ -120,7 +121,7 @@ namespace Directus
 		void SetShadingMode(const ShadingMode shading_mode)	{ m_shading_mode = shading_mode; }
 
 		const Math::Vector4& GetColorAlbedo() const			{ return m_color_albedo; }
-		void SetColorAlbedo(const Math::Vector4& color)		{ m_color_albedo = color; }
+		void SetColorAlbedo(const Math::Vector4& color);
 
 		const Math::Vector2& GetTiling() const				{ return m_uv_tiling; }
 		void SetTiling(const Math::Vector2& tiling)			{ m_uv_tiling = tiling; }
@@ -142,6 +143,11 @@ namespace Directus
 	private:
 		void TextureBasedMultiplierAdjustment();	
 
+		// The binary sidecar (next to the .mat, which stays the editable source), it's what loads when it's up to date
+		bool LoadFromFileBinary(const std::string& file_path);
+		bool SaveToFileBinary(const std::string& file_path, const std::string& file_path_xml);
+		void TextureSlotLoad(TextureType type, const std::string& texture_name, const std::string& texture_path);
+
 		RHI_Cull_Mode m_cull_mode;
 		ShadingMode m_shading_mode;
 		Math::Vector4 m_color_albedo;
@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Material.h"
 #include "../IO/FileStream.h"
 #include "../Core/Stopwatch.h"
+#include "../World/World.h"
 #include "../World/Entity.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
@@ -35,6 +36,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_IndexBuffer.h"
 #include "../RHI/RHI_Texture.h"
 #include "../Resource/ResourceCache.h"
+#include "../Threading/Threading.h"
+#include "../World/Prefab.h"
+#include "../Resource/Import/ImportCache.h"
 //=========================================
 
 //= NAMESPACES ================
@@ -44,6 +48,14 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace
+	{
+		// Version 1 files (no header) start with the name
+		const unsigned int g_model_magic		= 0x4C444F4D; // "MODL"
+		const unsigned int g_model_version		= 2;
+		const unsigned int g_model_compressed	= 1 << 0; // geometry is block compressed
+	}
+
 	Model::Model(Context* context) : IResource(context, Resource_Model)
 	{
 		m_normalized_scale	= 1.0f;
@@ -99,13 +111,27 @@ namespace Directus
 		if (!file->IsOpen())
 			return false;
 
+		const auto compressed = Settings::Get().GetAssetCompression();
+		file->Write(g_model_magic);
+		file->Write(g_model_version);
+		file->Write(compressed ? g_model_compressed : 0u);
+
 		file->Write(GetResourceName());
 		file->Write(GetResourceFilePath());
 		file->Write(m_normalized_scale);
-		file->Write(m_mesh->Indices_Get());
-		file->Write(m_mesh->Vertices_Get());	
+		if (compressed)
+		{
+			const auto threading = m_context->GetSubsystem<Threading>().get();
+			file->WriteCompressed(m_mesh->Indices_Get(), threading);
+			file->WriteCompressed(m_mesh->Vertices_Get(), threading);
+		}
+		else
+		{
+			file->Write(m_mesh->Indices_Get());
+			file->Write(m_mesh->Vertices_Get());
+		}
 
-		return true;
+		return file->Close();
 	}
 	//=======================================================
 
@@ -204,15 +230,26 @@ namespace Directus
 		// If we didn't get a texture, it's not cached, hence we have to load it and cache it now
 		else if (!texture)
 		{
-			// Load texture
 			texture = make_shared<RHI_Texture>(m_context);
+			const auto model_relative_tex_path = m_model_directory_textures + tex_name + EXTENSION_TEXTURE;
+
+			// Imported before and unchanged since, load what that import saved on the job system (its properties are known right away)
+			if (ImportCache::IsUpToDate(file_path, m_resource_manager->GetImageImporter()->GetImportSettings(texture.get()), model_relative_tex_path))
+			{
+				if (auto cached = m_resource_manager->LoadAsync<RHI_Texture>(model_relative_tex_path))
+				{
+					material->SetTextureSlot(texture_type, cached);
+				}
+				return;
+			}
+
+			// Load texture, synchronously since it's saved right after
 			texture->LoadFromFile(file_path);
 
 			// Update the texture with Model directory relative file path. Then save it to this directory
-			const auto model_relative_tex_path = m_model_directory_textures + tex_name + EXTENSION_TEXTURE;
 			texture->SetResourceFilePath(model_relative_tex_path);
 			texture->SetResourceName(FileSystem::GetFileNameNoExtensionFromFilePath(model_relative_tex_path));
-			texture->SaveToFile(model_relative_tex_path);		
+			texture->SaveToFile(model_relative_tex_path);
 			texture->ClearTextureBytes(); // Now that the texture is saved, free up it's memory since we already have a shader resource
 
 			// Set the texture to the provided material
@@ -237,15 +274,40 @@ namespace Directus
 	bool Model::LoadFromEngineFormat(const string& file_path)
 	{
 		// Deserialize
-		auto file = make_unique<FileStream>(file_path, FileStreamMode_Read);
+		auto file = make_unique<FileStream>(file_path, FileStreamMode_ReadMapped);
 		if (!file->IsOpen())
 			return false;
 
+		unsigned int flags = 0;
+		if (file->ReadAs<unsigned int>() == g_model_magic)
+		{
+			const auto version = file->ReadAs<unsigned int>();
+			if (version != g_model_version)
+			{
+				LOGF_ERROR("Unsupported model version %d.", version);
+				return false;
+			}
+			file->Read(&flags);
+		}
+		else
+		{
+			file->Seek(0);
+		}
+
 		SetResourceName(file->ReadAs<string>());
 		SetResourceFilePath(file->ReadAs<string>());
 		file->Read(&m_normalized_scale);
-		file->Read(&m_mesh->Indices_Get());
-		file->Read(&m_mesh->Vertices_Get());
+		if (flags & g_model_compressed)
+		{
+			const auto threading = m_context->GetSubsystem<Threading>().get();
+			file->ReadCompressed(&m_mesh->Indices_Get(), threading);
+			file->ReadCompressed(&m_mesh->Vertices_Get(), threading);
+		}
+		else
+		{
+			file->Read(&m_mesh->Indices_Get());
+			file->Read(&m_mesh->Vertices_Get());
+		}
 
 		GeometryUpdate();
 
@@ -259,8 +321,28 @@ namespace Directus
 		SetResourceFilePath(m_model_directory_model + FileSystem::GetFileNameNoExtensionFromFilePath(file_path) + EXTENSION_MODEL); // Assets/Sponza/Sponza.model
 		SetResourceName(FileSystem::GetFileNameNoExtensionFromFilePath(file_path)); // Sponza
 
+		// The hierarchy the import creates is kept as a prefab next to the model
+		const auto import_settings	= m_resource_manager->GetModelImporter()->GetImportSettings();
+		const auto prefab_path		= FileSystem::GetFilePathWithoutExtension(GetResourceFilePath()) + EXTENSION_PREFAB; // Assets/Sponza/Sponza.prefab
+
+		// Imported before and unchanged since, load what that import produced instead
+		if (ImportCache::IsUpToDate(file_path, import_settings, GetResourceFilePath()) && FileSystem::FileExists(prefab_path))
+		{
+			auto prefab = make_shared<Prefab>(m_context);
+			if (prefab->LoadFromFile(prefab_path) && LoadFromEngineFormat(GetResourceFilePath()))
+			{
+				// This can run on a worker, the world instantiates it when it's safe to
+				m_root_entity = m_context->GetSubsystem<World>()->PrefabInstantiate(*prefab);
+				return true;
+			}
+
+			LOGF_WARNING("Failed to load the previous import of \"%s\", importing it again.", file_path.c_str());
+			m_mesh->Geometry_Clear();
+		}
+
 		// Load the model
-		if (m_resource_manager->GetModelImporter()->Load(std::dynamic_pointer_cast<Model>(GetSharedPtr()), file_path))
+		vector<string> dependencies;
+		if (m_resource_manager->GetModelImporter()->Load(std::dynamic_pointer_cast<Model>(GetSharedPtr()), file_path, &dependencies))
 		{
 			// Set the normalized scale to the root entity's transform
 			m_normalized_scale = GeometryComputeNormalizedScale();
@@ -270,6 +352,13 @@ namespace Directus
 			// Save the model in our custom format.
 			SaveToFile(GetResourceFilePath());
 
+			// And the hierarchy, which lets the next load skip the import (animations aren't saved, so animated models are always imported)
+			auto prefab = make_shared<Prefab>(m_context);
+			if (!m_is_animated && prefab->CreateFromEntity(m_root_entity.lock().get()) && prefab->SaveToFile(prefab_path))
+			{
+				ImportCache::Store(file_path, import_settings, GetResourceFilePath(), dependencies);
+			}
+
 			return true;
 		}
 
@@ -332,8 +421,8 @@ namespace Directus
 		auto size = !m_mesh ? 0 : m_mesh->Geometry_MemoryUsage();
 
 		// Buffers
-		size += m_vertex_buffer->GetMemoryUsage();
-		size += m_index_buffer->GetMemoryUsage();
+		size += !m_vertex_buffer ? 0 : m_vertex_buffer->GetMemoryUsage();
+		size += !m_index_buffer ? 0 : m_index_buffer->GetMemoryUsage();
 
 		return size;
 	}
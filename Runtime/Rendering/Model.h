@@ -51,6 +51,7 @@ namespace Directus
 		//= RESOURCE INTERFACE =================================
 		bool LoadFromFile(const std::string& file_path) override;
 		bool SaveToFile(const std::string& file_path) override;
+		unsigned int GetMemoryUsage() override { return GeometryComputeMemoryUsage(); }
 		//======================================================
 
 		// Sets the entity that represents this model in the scene
@@ -21,10 +21,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==============================
 #include "Renderer.h"
+#include "Material.h"
 #include "ShaderBuffered.h"
 #include "Gizmos/Grid.h"
 #include "Gizmos/Transform_Gizmo.h"
 #include "Deferred/ShaderLight.h"
+#include "Deferred/ShaderVariation.h"
 #include "Utilities/Sampling.h"
 #include "Font/Font.h"
 #include "../Profiling/Profiler.h"
@@ -38,6 +40,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_BlendState.h"
 #include "../RHI/RHI_SwapChain.h"
 #include "../RHI/RHI_CommandList.h"
+#include "../World/World.h"
 #include "../World/Entity.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
@@ -114,15 +117,23 @@ namespace Directus
 		m_initialized = true;
 
 		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Submit, EVENT_HANDLER_VARIANT(RenderablesAcquire));
+		SUBSCRIBE_TO_EVENT(Event_World_EntityChanged,	[this](const Variant& var) { RenderablesQueue(var, false); });
+		SUBSCRIBE_TO_EVENT(Event_World_EntityRemoved,	[this](const Variant& var) { RenderablesQueue(var, true); });
+		SUBSCRIBE_TO_EVENT(Event_World_Unload,			EVENT_HANDLER(RenderablesQueueClear));
+		SUBSCRIBE_TO_EVENT(Event_Material_Transparency,	EVENT_HANDLER(RenderablesQueueTransparency));
 	}
 
 	Renderer::~Renderer()
 	{
 		// Unsubscribe from events
-		UNSUBSCRIBE_FROM_EVENT(Event_World_Submit, EVENT_HANDLER_VARIANT(RenderablesAcquire));
+		UNSUBSCRIBE_FROM_EVENT(Event_World_EntityChanged,	[this](const Variant& var) { RenderablesQueue(var, false); });
+		UNSUBSCRIBE_FROM_EVENT(Event_World_EntityRemoved,	[this](const Variant& var) { RenderablesQueue(var, true); });
+		UNSUBSCRIBE_FROM_EVENT(Event_World_Unload,			EVENT_HANDLER(RenderablesQueueClear));
+		UNSUBSCRIBE_FROM_EVENT(Event_Material_Transparency,	EVENT_HANDLER(RenderablesQueueTransparency));
 
 		m_entities.clear();
+		m_entities_registered.clear();
+		m_entities_pending.clear();
 		m_camera = nullptr;
 
 		// Log to file as the renderer is no more
@@ -134,7 +145,8 @@ namespace Directus
 		// Create/Get required systems		
 		g_resource_cache	= m_context->GetSubsystem<ResourceCache>().get();
 
-		m_profiler = m_context->GetSubsystem<Profiler>().get();
+		m_profiler	= m_context->GetSubsystem<Profiler>().get();
+		m_world		= m_context->GetSubsystem<World>().get();
 
 		// Editor specific
 		m_gizmo_grid		= make_unique<Grid>(m_rhi_device);
@@ -155,9 +167,41 @@ namespace Directus
 		CreateSamplers();
 		CreateTextures();
 
+		// Drawn in place of materials which are still loading
+		m_material_placeholder = make_shared<Material>(m_context);
+		m_material_placeholder->SetColorAlbedo(Vector4(0.5f, 0.5f, 0.5f, 1.0f));
+
 		return true;
 	}
 
+	void Renderer::ReloadShaders()
+	{
+		// The renderer's own shaders are simply created again
+		CreateShaders();
+
+		// Material shaders are variations shared between materials, every material in use acquires a new one
+		ShaderVariation::ClearVariations();
+		m_material_placeholder->AcquireShader();
+		for (const auto type : { Renderable_ObjectOpaque, Renderable_ObjectTransparent })
+		{
+			for (const auto& entity : m_entities[type])
+			{
+				const auto renderable = entity->GetRenderable_PtrRaw();
+				if (renderable && renderable->MaterialExists() && renderable->MaterialPtr()->GetLoadState() != LoadState_Started)
+				{
+					renderable->MaterialPtr()->AcquireShader();
+				}
+			}
+		}
+		for (const auto& material : g_resource_cache->GetByType(Resource_Material))
+		{
+			if (material->GetLoadState() != LoadState_Started)
+			{
+				static_pointer_cast<Material>(material)->AcquireShader();
+			}
+		}
+	}
+
 	void Renderer::CreateDepthStencilStates()
 	{
 		m_depth_stencil_enabled		= make_shared<RHI_DepthStencilState>(m_rhi_device, true);
@@ -442,6 +486,9 @@ namespace Directus
 		if (!m_rhi_device || !m_rhi_device->IsInitialized())
 			return;
 
+		// Apply any changes the world has made since the last frame
+		RenderablesUpdate();
+
 		// If there is no camera, do nothing
 		if (!m_camera)
 		{
@@ -451,7 +498,7 @@ namespace Directus
 		}
 
 		// If there is nothing to render clear to camera's color and present
-		if (m_entities.empty())
+		if (m_entities_registered.empty())
 		{
 			m_render_tex_full_hdr_light2->Clear(m_camera->GetClearColor());
 			m_is_rendering = false;
@@ -599,107 +646,261 @@ namespace Directus
 		m_buffer_global->Unmap();
 	}
 
-	void Renderer::RenderablesAcquire(const Variant& entities_variant)
+	void Renderer::RenderablesQueue(const Variant& entity_variant, const bool removed)
 	{
+		const auto& entity = entity_variant.Get<shared_ptr<Entity>>();
+		if (!entity)
+			return;
+
+		// Only the latest change matters, so multiple changes to the same entity coalesce into one
+		lock_guard<mutex> lock(m_entities_pending_mutex);
+		m_entities_pending[entity.get()] = removed ? nullptr : entity;
+	}
+
+	void Renderer::RenderablesQueueClear()
+	{
+		lock_guard<mutex> lock(m_entities_pending_mutex);
+		m_entities_pending.clear();
+		m_entities_pending_clear = true;
+	}
+
+	void Renderer::RenderablesQueueTransparency()
+	{
+		lock_guard<mutex> lock(m_entities_pending_mutex);
+		m_entities_pending_transparency = true;
+	}
+
+	void Renderer::RenderablesUpdate()
+	{
+		// Grab the pending changes
+		unordered_map<Entity*, shared_ptr<Entity>> pending;
+		bool clear			= false;
+		bool transparency	= false;
+		{
+			lock_guard<mutex> lock(m_entities_pending_mutex);
+			pending.swap(m_entities_pending);
+			clear							= m_entities_pending_clear;
+			transparency					= m_entities_pending_transparency;
+			m_entities_pending_clear		= false;
+			m_entities_pending_transparency	= false;
+		}
+
+		if (pending.empty() && !clear && !transparency)
+			return;
+
 		TIME_BLOCK_START_CPU(m_profiler);
 
-		// Clear previous state
-		m_entities.clear();
-		m_camera = nullptr;
-		m_skybox = nullptr;
-		
-		auto entities_vec = entities_variant.Get<vector<shared_ptr<Entity>>>();
-		for (const auto& entitieshared : entities_vec)
+		// The world was unloaded
+		if (clear)
 		{
-			auto entity = entitieshared.get();
-			if (!entity)
-				continue;
+			for (auto& list : m_entities)
+			{
+				list.second.clear();
+			}
+			m_entities_registered.clear();
+			m_camera = nullptr;
+			m_skybox = nullptr;
+		}
 
-			// Get all the components we are interested in
-			auto renderable = entity->GetComponent<Renderable>();
-			auto light		= entity->GetComponent<Light>();
-			auto skybox		= entity->GetComponent<Skybox>();
-			auto camera		= entity->GetComponent<Camera>();
+		// Re-evaluate only the entities which changed
+		for (const auto& change : pending)
+		{
+			RenderableRemove(change.first);
 
-			if (renderable)
+			if (change.second)
 			{
-				const auto is_transparent = !renderable->MaterialExists() ? false : renderable->MaterialPtr()->GetColorAlbedo().w < 1.0f;
-				if (!skybox) // Ignore skybox
+				RenderableAdd(change.second);
+			}
+		}
+
+		// A material switched between opaque and transparent, move the entities which use it
+		if (transparency)
+		{
+			vector<shared_ptr<Entity>> moved;
+			for (const auto& registered : m_entities_registered)
+			{
+				const auto& entry = registered.second;
+				if (!entry.opaque && !entry.transparent)
+					continue;
+
+				auto renderable				= entry.entity->GetComponent<Renderable>();
+				const auto is_transparent	= renderable && renderable->MaterialExists() && renderable->MaterialPtr()->GetColorAlbedo().w < 1.0f;
+				if (is_transparent != entry.transparent)
 				{
-					m_entities[is_transparent ? Renderable_ObjectTransparent : Renderable_ObjectOpaque].emplace_back(entity);
+					moved.emplace_back(entry.entity);
 				}
 			}
 
-			if (light)
+			for (const auto& entity : moved)
 			{
-				m_entities[Renderable_Light].emplace_back(entity);
+				RenderableRemove(entity.get());
+				RenderableAdd(entity);
 			}
+		}
+
+		TIME_BLOCK_END(m_profiler);
+	}
+
+	void Renderer::RenderableAdd(const shared_ptr<Entity>& entity)
+	{
+		// Get all the components we are interested in
+		auto renderable	= entity->GetComponent<Renderable>();
+		auto light		= entity->GetComponent<Light>();
+		auto skybox		= entity->GetComponent<Skybox>();
+		auto camera		= entity->GetComponent<Camera>();
+
+		// Nothing to render
+		if (!renderable && !light && !skybox && !camera)
+			return;
+
+		auto& entry		= m_entities_registered[entity.get()];
+		entry.entity	= entity;
 
-			if (skybox)
+		if (renderable && !skybox) // Ignore skybox
+		{
+			const auto material	= renderable->MaterialPtr();
+			entry.transparent	= material ? material->GetColorAlbedo().w < 1.0f : false;
+			entry.opaque		= !entry.transparent;
+			entry.material_id	= material ? material->GetResourceId() : 0;
+
+			// Insert sorted by material, so that entities which share a material are drawn together
+			auto& list		= m_entities[entry.transparent ? Renderable_ObjectTransparent : Renderable_ObjectOpaque];
+			const auto it	= upper_bound(list.begin(), list.end(), entry.material_id, [this](const unsigned int material_id, Entity* other)
 			{
-				m_skybox = skybox;
-			}
+				return material_id < m_entities_registered[other].material_id;
+			});
+			list.insert(it, entity.get());
+		}
+
+		if (light)
+		{
+			entry.light = true;
+			m_entities[Renderable_Light].emplace_back(entity.get());
+		}
 
-			if (camera)
+		if (skybox)
+		{
+			entry.skybox	= true;
+			m_skybox		= skybox;
+		}
+
+		if (camera)
+		{
+			entry.camera = true;
+			m_entities[Renderable_Camera].emplace_back(entity.get());
+			m_camera = camera;
+		}
+	}
+
+	void Renderer::RenderableRemove(Entity* entity)
+	{
+		auto it = m_entities_registered.find(entity);
+		if (it == m_entities_registered.end())
+			return;
+
+		const auto& entry = it->second;
+
+		if (entry.opaque || entry.transparent)
+		{
+			// Only the entities with the same material have to be searched
+			auto& list			= m_entities[entry.transparent ? Renderable_ObjectTransparent : Renderable_ObjectOpaque];
+			const auto range	= equal_range(list.begin(), list.end(), entity, [this](Entity* a, Entity* b)
 			{
-				m_entities[Renderable_Camera].emplace_back(entity);
-				m_camera = camera;
+				return m_entities_registered[a].material_id < m_entities_registered[b].material_id;
+			});
+			const auto it_list = find(range.first, range.second, entity);
+			if (it_list != range.second)
+			{
+				list.erase(it_list);
 			}
 		}
 
-		RenderablesSort(&m_entities[Renderable_ObjectOpaque]);
-		RenderablesSort(&m_entities[Renderable_ObjectTransparent]);
+		if (entry.light)
+		{
+			auto& list = m_entities[Renderable_Light];
+			list.erase(remove(list.begin(), list.end(), entity), list.end());
+		}
 
-		TIME_BLOCK_END(m_profiler);
+		if (entry.skybox && m_skybox && m_skybox->GetEntity_PtrRaw() == entity)
+		{
+			m_skybox = nullptr;
+		}
+
+		if (entry.camera)
+		{
+			auto& list = m_entities[Renderable_Camera];
+			list.erase(remove(list.begin(), list.end(), entity), list.end());
+
+			// Fall back to any other camera
+			if (m_camera && m_camera->GetEntity_PtrRaw() == entity)
+			{
+				m_camera = list.empty() ? nullptr : list.back()->GetComponent<Camera>();
+			}
+		}
+
+		m_entities_registered.erase(it);
 	}
 
-	void Renderer::RenderablesSort(vector<Entity*>* renderables)
+	void Renderer::RenderablesCull(const RenderableType type, vector<Entity*>* entities)
 	{
-		if (renderables->size() <= 2)
+		// The spatial index knows nothing about the renderer, keep what was placed in the requested list
+		auto it_kept = entities->begin();
+		for (auto entity : *entities)
+		{
+			const auto it = m_entities_registered.find(entity);
+			if (it == m_entities_registered.end())
+				continue;
+
+			if ((type == Renderable_ObjectOpaque && it->second.opaque) || (type == Renderable_ObjectTransparent && it->second.transparent))
+			{
+				*it_kept++ = entity;
+			}
+		}
+		entities->erase(it_kept, entities->end());
+
+		if (!m_camera || entities->size() <= 1)
 			return;
 
-		// Sort by depth (front to back)
-		if (m_camera)
+		// Depth is computed once per entity, not per comparison
+		const auto camera_position = m_camera->GetTransform()->GetPosition();
+		auto depth = [&camera_position](Entity* entity)
+		{
+			const auto renderable = entity->GetRenderable_PtrRaw();
+			return renderable ? (renderable->GeometryAabb().GetCenter() - camera_position).LengthSquared() : 0.0f;
+		};
+
+		if (type == Renderable_ObjectTransparent)
 		{
-			sort(renderables->begin(), renderables->end(), [this](Entity* a, Entity* b)
+			// Back to front, blending is only correct in that order
+			vector<pair<float, Entity*>> sorted;
+			sorted.reserve(entities->size());
+			for (auto entity : *entities)
 			{
-				// Get renderable component
-				auto a_renderable = a->GetRenderable_PtrRaw();
-				auto b_renderable = b->GetRenderable_PtrRaw();
-				if (!a_renderable || !b_renderable)
-					return false;
-
-				// Get materials
-				const auto a_material = a_renderable->MaterialPtr();
-				const auto b_material = b_renderable->MaterialPtr();
-				if (!a_material || !b_material)
-					return false;
-
-				const auto a_depth = (a_renderable->GeometryAabb().GetCenter() - m_camera->GetTransform()->GetPosition()).LengthSquared();
-				const auto b_depth = (b_renderable->GeometryAabb().GetCenter() - m_camera->GetTransform()->GetPosition()).LengthSquared();
-
-				return a_depth < b_depth;
-			});
+				sorted.emplace_back(depth(entity), entity);
+			}
+			sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+			for (size_t i = 0; i < sorted.size(); i++)
+			{
+				(*entities)[i] = sorted[i].second;
+			}
+			return;
 		}
 
-		// Sort by material
-		sort(renderables->begin(), renderables->end(), [](Entity* a, Entity* b)
+		// By material, so state changes are kept to a minimum, then front to back so early depth testing rejects what's hidden
+		vector<tuple<unsigned int, float, Entity*>> sorted;
+		sorted.reserve(entities->size());
+		for (auto entity : *entities)
+		{
+			sorted.emplace_back(m_entities_registered[entity].material_id, depth(entity), entity);
+		}
+		sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b)
 		{
-			// Get renderable component
-			const auto a_renderable = a->GetRenderable_PtrRaw();
-			const auto b_renderable = b->GetRenderable_PtrRaw();
-			if (!a_renderable || !b_renderable)
-				return false;
-
-			// Get materials
-			const auto a_material = a_renderable->MaterialPtr();
-			const auto b_material = b_renderable->MaterialPtr();
-			if (!a_material || !b_material)
-				return false;
-
-			// Order doesn't matter, as long as they are not mixed
-			return a_material->GetResourceId() < b_material->GetResourceId();
+			return get<0>(a) != get<0>(b) ? get<0>(a) < get<0>(b) : get<1>(a) < get<1>(b);
 		});
+		for (size_t i = 0; i < sorted.size(); i++)
+		{
+			(*entities)[i] = get<2>(sorted[i]);
+		}
 	}
 
 	shared_ptr<RHI_RasterizerState>& Renderer::GetRasterizerState(const RHI_Cull_Mode cull_mode, const RHI_Fill_Mode fill_mode)
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <mutex>
 #include "../Core/ISubsystem.h"
 #include "../Math/Matrix.h"
 #include "../Math/Vector2.h"
@@ -48,6 +49,8 @@ namespace Directus
 	class ShaderLight;
 	class ShaderBuffered;
 	class Profiler;
+	class World;
+	class Material;
 
 	namespace Math
 	{
@@ -181,6 +184,8 @@ namespace Directus
 		std::shared_ptr<Camera> GetCamera() const	{ return m_camera; }
 		unsigned int GetMaxResolution() const		{ return m_max_resolution; }
 		bool IsInitialized() const					{ return m_initialized; }
+		// Compiles all shaders again, e.g. after their source changed
+		void ReloadShaders();
 		//======================================================================
 
 	private:
@@ -193,8 +198,13 @@ namespace Directus
 		void CreateSamplers();
 		void CreateRenderTextures();
 		void SetDefaultBuffer(unsigned int resolution_width, unsigned int resolution_height, const Math::Matrix& mMVP = Math::Matrix::Identity) const;
-		void RenderablesAcquire(const Variant& renderables);
-		void RenderablesSort(std::vector<Entity*>* renderables);
+		void RenderablesQueue(const Variant& entity, bool removed);
+		void RenderablesQueueClear();
+		void RenderablesQueueTransparency();
+		void RenderablesUpdate();
+		void RenderableAdd(const std::shared_ptr<Entity>& entity);
+		void RenderableRemove(Entity* entity);
+		void RenderablesCull(RenderableType type, std::vector<Entity*>* entities);
 		std::shared_ptr<RHI_RasterizerState>& GetRasterizerState(RHI_Cull_Mode cull_mode, RHI_Fill_Mode fill_mode);
 
 		//= PASSES ===========================================================================================================================================================================
@@ -317,6 +327,10 @@ namespace Directus
 		std::shared_ptr<RHI_Texture> m_gizmo_tex_light_spot;
 		//=========================================================
 
+		//= STANDARD MATERIALS ==========================
+		std::shared_ptr<Material> m_material_placeholder;
+		//===============================================
+
 		//= LINE RENDERING ========================================
 		std::shared_ptr<RHI_VertexBuffer> m_vertex_buffer_lines;
 		std::vector<RHI_Vertex_PosCol> m_lines_list_depth_enabled;
@@ -358,6 +372,29 @@ namespace Directus
 		//= ENTITIES/COMPONENTS ============================================
 		Light* GetLightDirectional();
 		std::unordered_map<RenderableType, std::vector<Entity*>> m_entities;
+
+		// Which lists an entity was placed in (also keeps it alive for as long as the renderer references it)
+		struct RenderableEntry
+		{
+			std::shared_ptr<Entity> entity;
+			unsigned int material_id	= 0;
+			bool opaque					= false;
+			bool transparent			= false;
+			bool light					= false;
+			bool camera					= false;
+			bool skybox					= false;
+		};
+		std::unordered_map<Entity*, RenderableEntry> m_entities_registered;
+
+		// Changes coming from the world (any thread), applied at the start of the next frame. A null entity means removal.
+		std::unordered_map<Entity*, std::shared_ptr<Entity>> m_entities_pending;
+		bool m_entities_pending_clear			= false;
+		bool m_entities_pending_transparency	= false;
+		std::mutex m_entities_pending_mutex;
+
+		// Entities returned by the world's spatial index for the pass being rendered
+		std::vector<Entity*> m_entities_culled;
+		World* m_world = nullptr;
 		float m_near_plane;
 		float m_far_plane;
 		std::shared_ptr<Camera> m_camera;
@@ -38,6 +38,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_Texture.h"
 #include "../RHI/RHI_Sampler.h"
 #include "../RHI/RHI_CommandList.h"
+#include "../World/World.h"
 #include "../World/Entity.h"
 #include "../World/Components/Renderable.h"
 #include "../World/Components/Transform.h"
@@ -133,27 +134,41 @@ namespace Directus
 			m_cmd_list->SetRenderTarget(shadow_map->GetRenderTargetView(i), shadow_map->GetDepthStencilView());
 			m_cmd_list->ClearDepthStencil(shadow_map->GetDepthStencilView(), Clear_Depth, clear_depth);
 
-			for (const auto& entity : entities)
+			// Only the casters inside the cascade's volume, found by un-projecting the corners of its clip space
+			const auto view_projection_inv = (light_directional->GetViewMatrix() * light_directional->ShadowMap_GetProjectionMatrix(cascade_index)).Inverted();
+			auto cascade_min = Vector3(INFINITY);
+			auto cascade_max = Vector3(-INFINITY);
+			for (unsigned int corner = 0; corner < 8; corner++)
+			{
+				const auto position = view_projection_inv * Vector3((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : 0.0f);
+				cascade_min = Vector3(Min(cascade_min.x, position.x), Min(cascade_min.y, position.y), Min(cascade_min.z, position.z));
+				cascade_max = Vector3(Max(cascade_max.x, position.x), Max(cascade_max.y, position.y), Max(cascade_max.z, position.z));
+			}
+			m_entities_culled.clear();
+			m_world->QueryAABB(BoundingBox(cascade_min, cascade_max), &m_entities_culled, Tag_ShadowCaster);
+			RenderablesCull(Renderable_ObjectOpaque, &m_entities_culled);
+
+			for (const auto& entity : m_entities_culled)
 			{
 				// Acquire renderable component
 				auto renderable = entity->GetRenderable_PtrRaw();
 				if (!renderable)
 					continue;
 	
-				// Acquire material
+				// Acquire material, the placeholder stands in for one which is still loading
 				auto material = renderable->MaterialPtr();
 				if (!material)
 					continue;
+				if (material->GetLoadState() == LoadState_Started)
+				{
+					material = m_material_placeholder;
+				}
 
 				// Acquire geometry
 				auto model = renderable->GeometryModel();
 				if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
 					continue;
 
-				// Skip meshes that don't cast shadows
-				if (!renderable->GetCastShadows())
-					continue;
-
 				// Skip transparent meshes (for now)
 				if (material->GetColorAlbedo().w < 1.0f)
 					continue;
@@ -238,7 +253,12 @@ namespace Directus
 		unsigned int currently_bound_shader		= 0;
 		unsigned int currently_bound_material	= 0;
 
-		for (auto entity : m_entities[Renderable_ObjectOpaque])
+		// Only what the camera can see
+		m_entities_culled.clear();
+		m_world->QueryFrustum(m_camera->GetFrustum(), &m_entities_culled);
+		RenderablesCull(Renderable_ObjectOpaque, &m_entities_culled);
+
+		for (auto entity : m_entities_culled)
 		{
 			// Get renderable and material
 			auto renderable = entity->GetRenderable_PtrRaw();
@@ -247,6 +267,12 @@ namespace Directus
 			if (!renderable || !material)
 				continue;
 
+			// The placeholder stands in for materials which are still loading
+			if (material->GetLoadState() == LoadState_Started)
+			{
+				material = m_material_placeholder.get();
+			}
+
 			// Get shader and geometry
 			auto shader = material->GetShader();
 			auto model	= renderable->GeometryModel();
@@ -259,10 +285,6 @@ namespace Directus
 			if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
 				continue;
 
-			// Skip objects outside of the view frustum
-			if (!m_camera->IsInViewFrustrum(renderable))
-				continue;
-
 			// Set face culling (changes only if required)
 			m_cmd_list->SetRasterizerState(GetRasterizerState(material->GetCullMode(), Fill_Solid));
 
@@ -439,13 +461,19 @@ namespace Directus
 		m_cmd_list->SetInputLayout(m_vps_transparent->GetInputLayout());
 		m_cmd_list->SetShaderPixel(m_vps_transparent);
 
-		for (auto& entity : entities_transparent)
+		// Only what the camera can see
+		m_entities_culled.clear();
+		m_world->QueryFrustum(m_camera->GetFrustum(), &m_entities_culled);
+		RenderablesCull(Renderable_ObjectTransparent, &m_entities_culled);
+
+		for (auto& entity : m_entities_culled)
 		{
 			// Get renderable and material
 			auto renderable	= entity->GetRenderable_PtrRaw();
 			auto material	= renderable ? renderable->MaterialPtr().get() : nullptr;
 
-			if (!renderable || !material)
+			// Materials which are still loading are skipped, a placeholder would be opaque
+			if (!renderable || !material || material->GetLoadState() == LoadState_Started)
 				continue;
 
 			// Get geometry
@@ -453,10 +481,6 @@ namespace Directus
 			if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
 				continue;
 
-			// Skip objects outside of the view frustum
-			if (!m_camera->IsInViewFrustrum(renderable))
-				continue;
-
 			// Set the following per object
 			m_cmd_list->SetRasterizerState(GetRasterizerState(material->GetCullMode(), Fill_Solid));
 			m_cmd_list->SetBufferIndex(model->GetIndexBuffer());
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Rendering/Model.h"
 #include "../Rendering/Font/Font.h"
 #include "../Rendering/Deferred/ShaderVariation.h"
+#include "../World/Prefab.h"
 //================================================
 
 //= NAMESPACES ==========
@@ -54,4 +55,5 @@ INSTANTIATE_TO_RESOURCE_TYPE(ShaderVariation,	Resource_Shader)
 INSTANTIATE_TO_RESOURCE_TYPE(Mesh,				Resource_Mesh)
 INSTANTIATE_TO_RESOURCE_TYPE(Model,				Resource_Model)
 INSTANTIATE_TO_RESOURCE_TYPE(Animation,			Resource_Animation)
-INSTANTIATE_TO_RESOURCE_TYPE(Font,				Resource_Font)
\ No newline at end of file
+INSTANTIATE_TO_RESOURCE_TYPE(Font,				Resource_Font)
+INSTANTIATE_TO_RESOURCE_TYPE(Prefab,			Resource_Prefab)
\ No newline at end of file
@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ========================
 #include <memory>
+#include <atomic>
 #include "../Core/Context.h"
 #include "../FileSystem/FileSystem.h"
 #include "../Logging/Log.h"
@@ -41,7 +42,8 @@ namespace Directus
 		Resource_Cubemap,	
 		Resource_Animation,
 		Resource_Font,
-		Resource_Shader
+		Resource_Shader,
+		Resource_Prefab
 	};
 
 	enum LoadState
@@ -74,11 +76,16 @@ namespace Directus
 		virtual unsigned int GetMemoryUsage()					{ return static_cast<unsigned int>(sizeof(*this)); }
 		LoadState GetLoadState() const				{ return m_load_state; }
 		void SetLoadState(const LoadState state)	{ m_load_state = state; }
+		// When the resource was last used, in ResourceCache residency ticks
+		uint64_t GetLastUsed() const				{ return m_last_used; }
+		void SetLastUsed(const uint64_t tick)		{ m_last_used = tick; }
 		//======================================================================================================================================
 
 		//= IO =================================================================
 		virtual bool SaveToFile(const std::string& file_path)	{ return true; }
 		virtual bool LoadFromFile(const std::string& file_path)	{ return true; }
+		// Reads what's cheap to read ahead of LoadFromFile(), so it's known while the rest loads
+		virtual bool LoadMetadata(const std::string& file_path)	{ return true; }
 		//======================================================================
 
 		//= TYPE ===================================
@@ -92,12 +99,13 @@ namespace Directus
 
 	protected:
 		Resource_Type m_resource_type = Resource_Unknown;
-		LoadState m_load_state			= LoadState_Idle;
+		std::atomic<LoadState> m_load_state	= LoadState_Idle;
 		Context* m_context				= nullptr;
 
 	private:
 		unsigned int m_resource_id			= NOT_ASSIGNED_HASH;
 		std::string m_resource_name			= NOT_ASSIGNED;
 		std::string m_resource_file_path	= NOT_ASSIGNED;
+		std::atomic<uint64_t> m_last_used	= 0;
 	};
 }
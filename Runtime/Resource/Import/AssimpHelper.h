@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <assimp/scene.h>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/ProgressHandler.hpp>
+#include <assimp/DefaultIOSystem.h>
 #include "../../Math/Vector2.h"
 #include "../../Math/Vector3.h"
 #include "../../Math/Matrix.h"
@@ -173,6 +174,26 @@ namespace Directus::AssimpHelper
 		std::string m_file_name;
 	};
 
+	// Implement Assimp::IOSystem, remembers the files an import reads (an OBJ's .mtl for example)
+	class AssimpIOSystem : public Assimp::DefaultIOSystem
+	{
+	public:
+		AssimpIOSystem(std::vector<std::string>* file_paths) { m_file_paths = file_paths; }
+
+		Assimp::IOStream* Open(const char* file_path, const char* mode = "rb") override
+		{
+			const auto stream = DefaultIOSystem::Open(file_path, mode);
+			if (stream)
+			{
+				m_file_paths->emplace_back(file_path);
+			}
+			return stream;
+		}
+
+	private:
+		std::vector<std::string>* m_file_paths;
+	};
+
 	inline std::string texture_try_multiple_extensions(const std::string& file_path)
 	{
 		// Remove extension
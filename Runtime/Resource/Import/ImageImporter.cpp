@@ -84,6 +84,16 @@ namespace Directus
 		FreeImage_DeInitialise();
 	}
 
+	string ImageImporter::GetImportSettings(const RHI_Texture* texture) const
+	{
+		// Width and height are a requested size, if set
+		return
+			"freeimage="	+ Settings::Get().m_versionFreeImage +
+			";mips="		+ to_string(texture->GetNeedsMipChain()) +
+			";width="		+ to_string(texture->GetWidth()) +
+			";height="		+ to_string(texture->GetHeight());
+	}
+
 	bool ImageImporter::Load(const string& file_path, RHI_Texture* texture)
 	{
 		if (!texture)
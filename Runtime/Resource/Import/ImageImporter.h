@@ -60,6 +60,7 @@ XPM files[reading, writing]
 
 //= INCLUDES ========================
 #include <vector>
+#include <string>
 #include "../../Core/EngineDefs.h"
 #include "../../RHI/RHI_Definition.h"
 //===================================
@@ -78,6 +79,9 @@ namespace Directus
 
 		bool Load(const std::string& file_path, RHI_Texture* texture);
 
+		// Everything that affects the result of importing into texture (as it's currently set up), for the import cache
+		std::string GetImportSettings(const RHI_Texture* texture) const;
+
 	private:	
 		bool GetBitsFromFibitmap(std::vector<std::byte>* data, FIBITMAP* bitmap, unsigned int width, unsigned int height, unsigned int channels);
 		void GenerateMipmaps(FIBITMAP* bitmap, RHI_Texture* texture, unsigned int width, unsigned int height, unsigned int channels);
@@ -0,0 +1,192 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "ImportCache.h"
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <filesystem>
+#include "../../IO/XmlDocument.h"
+#include "../../Logging/Log.h"
+#include "../../FileSystem/FileSystem.h"
+//===================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Directus
+{
+	namespace
+	{
+		// Bump when importers change in a way that makes previously imported assets stale
+		const unsigned int g_import_cache_version = 1;
+
+		const uint64_t g_fnv_offset	= 14695981039346656037ull;
+		const uint64_t g_fnv_prime	= 1099511628211ull;
+
+		// FNV-1a, over 8 byte words (bytes for the tail) to keep up with the disk
+		uint64_t hash_bytes(uint64_t hash, const char* data, const size_t size)
+		{
+			size_t i = 0;
+			for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+			{
+				uint64_t word;
+				memcpy(&word, data + i, sizeof(word));
+				hash = (hash ^ word) * g_fnv_prime;
+			}
+			for (; i < size; i++)
+			{
+				hash = (hash ^ static_cast<unsigned char>(data[i])) * g_fnv_prime;
+			}
+			return hash;
+		}
+
+		// Size and modification time, a cheap way to tell that a file hasn't been touched
+		bool file_stamp(const string& path, string* size, string* time)
+		{
+			error_code error;
+			const auto file_size = filesystem::file_size(path, error);
+			if (error)
+				return false;
+
+			const auto file_time = filesystem::last_write_time(path, error);
+			if (error)
+				return false;
+
+			*size = to_string(file_size);
+			*time = to_string(file_time.time_since_epoch().count());
+			return true;
+		}
+	}
+
+	uint64_t ImportCache::Hash(const string& source_path, const string& settings)
+	{
+		ifstream file(source_path, ios::in | ios::binary);
+		if (!file.is_open())
+			return 0;
+
+		auto hash = hash_bytes(g_fnv_offset, settings.data(), settings.size());
+		hash = hash_bytes(hash, reinterpret_cast<const char*>(&g_import_cache_version), sizeof(g_import_cache_version));
+
+		vector<char> buffer(1024 * 1024);
+		while (file)
+		{
+			file.read(buffer.data(), buffer.size());
+			hash = hash_bytes(hash, buffer.data(), static_cast<size_t>(file.gcount()));
+		}
+
+		return hash;
+	}
+
+	bool ImportCache::IsUpToDate(const string& source_path, const string& settings, const string& asset_path)
+	{
+		const auto metadata_path = GetMetadataPath(asset_path);
+		if (!FileSystem::FileExists(asset_path) || !FileSystem::FileExists(metadata_path))
+			return false;
+
+		auto xml = make_unique<XmlDocument>();
+		if (!xml->Load(metadata_path))
+			return false;
+
+		string hash, size, time;
+		if (!xml->GetAttribute("Import", "Hash", &hash) || !xml->GetAttribute("Import", "Size", &size) || !xml->GetAttribute("Import", "Time", &time))
+			return false;
+
+		// Any dependency (an OBJ's .mtl, a texture) that changed makes the whole import stale.
+		// Records from before dependencies were tracked have none, they are imported once more.
+		vector<string> dependencies;
+		unsigned int dependency_count = 0;
+		if (!xml->GetAttribute("Dependencies", "Count", &dependency_count))
+			return false;
+		for (unsigned int i = 0; i < dependency_count; i++)
+		{
+			const auto node = "Dependency_" + to_string(i);
+			const auto path = xml->GetAttributeAs<string>(node, "Path");
+			string dependency_size, dependency_time;
+			if (!file_stamp(path, &dependency_size, &dependency_time) || dependency_size != xml->GetAttributeAs<string>(node, "Size") || dependency_time != xml->GetAttributeAs<string>(node, "Time"))
+				return false;
+			dependencies.emplace_back(path);
+		}
+
+		string source_size, source_time;
+		if (!file_stamp(source_path, &source_size, &source_time))
+			return false;
+
+		// Untouched since it was imported, but a different size means different contents, no need to hash
+		if (source_size != size)
+			return false;
+		if (source_time == time && xml->GetAttributeAs<string>("Import", "Settings") == settings)
+			return true;
+
+		// Touched (copied, checked out, saved as is), only an actual change in contents counts
+		if (to_string(Hash(source_path, settings)) != hash)
+			return false;
+
+		// Same contents, record the new time so it isn't hashed again
+		Store(source_path, settings, asset_path, dependencies);
+		return true;
+	}
+
+	bool ImportCache::Store(const string& source_path, const string& settings, const string& asset_path, const vector<string>& dependencies)
+	{
+		string size, time;
+		if (!file_stamp(source_path, &size, &time))
+			return false;
+
+		auto xml = make_unique<XmlDocument>();
+		xml->AddNode("Import");
+		xml->AddAttribute("Import", "Source",	source_path);
+		xml->AddAttribute("Import", "Settings",	settings);
+		xml->AddAttribute("Import", "Hash",		to_string(Hash(source_path, settings)));
+		xml->AddAttribute("Import", "Size",		size);
+		xml->AddAttribute("Import", "Time",		time);
+
+		xml->AddChildNode("Import", "Dependencies");
+		xml->AddAttribute("Dependencies", "Count", static_cast<unsigned int>(dependencies.size()));
+		for (unsigned int i = 0; i < static_cast<unsigned int>(dependencies.size()); i++)
+		{
+			// One that can't be stamped (gone already) is recorded as is, so the next check fails
+			string dependency_size, dependency_time;
+			file_stamp(dependencies[i], &dependency_size, &dependency_time);
+
+			const auto node = "Dependency_" + to_string(i);
+			xml->AddChildNode("Dependencies", node);
+			xml->AddAttribute(node, "Path", dependencies[i]);
+			xml->AddAttribute(node, "Size", dependency_size);
+			xml->AddAttribute(node, "Time", dependency_time);
+		}
+
+		if (!xml->Save(GetMetadataPath(asset_path)))
+		{
+			LOGF_WARNING("Failed to save the import metadata of \"%s\".", asset_path.c_str());
+			return false;
+		}
+
+		return true;
+	}
+
+	string ImportCache::GetMetadataPath(const string& asset_path)
+	{
+		return asset_path + METADATA_EXTENSION;
+	}
+}
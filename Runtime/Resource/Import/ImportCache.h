@@ -0,0 +1,51 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <string>
+#include <vector>
+#include "../../Core/EngineDefs.h"
+//================================
+
+namespace Directus
+{
+	// Remembers which source file, and with which import settings, an engine asset was imported from.
+	// The record is a metadata file next to the asset (asset path + METADATA_EXTENSION), which lets
+	// importers load the engine asset instead of importing an unchanged source again.
+	class ENGINE_CLASS ImportCache
+	{
+	public:
+		// Hash of the source file's contents and the settings it's imported with
+		static uint64_t Hash(const std::string& source_path, const std::string& settings);
+
+		// True if asset_path exists and was imported from the current contents of source_path with the same settings.
+		// The source is only hashed again if its size or modification time changed since it was recorded, any change
+		// to the size or modification time of a dependency makes the asset stale.
+		static bool IsUpToDate(const std::string& source_path, const std::string& settings, const std::string& asset_path);
+
+		// Records that asset_path was just imported from source_path, and the other files the import read
+		static bool Store(const std::string& source_path, const std::string& settings, const std::string& asset_path, const std::vector<std::string>& dependencies = {});
+
+		static std::string GetMetadataPath(const std::string& asset_path);
+	};
+}
@@ -46,7 +46,10 @@ namespace Directus
 	{
 		static float max_normal_smoothing_angle		= 80.0f;	// Normals exceeding this limit are not smoothed.
 		static float max_tangent_smoothing_angle	= 80.0f;	// Tangents exceeding this limit are not smoothed. Default is 45, max is 175
+		static const unsigned int triangle_limit	= 1000000;	// Maximum number of triangles in a mesh (before splitting)
+		static const unsigned int vertex_limit		= 1000000;	// Maximum number of vertices in a mesh (before splitting)
 		std::string m_model_path;
+		std::vector<std::string> m_dependencies;
 
 		// Things for Assimp to do
 		static auto flags =
@@ -80,7 +83,18 @@ namespace Directus
 		Settings::Get().m_versionAssimp = to_string(major) + "." + to_string(minor) + "." + to_string(rev);
 	}
 
-	bool ModelImporter::Load(shared_ptr<Model> model, const string& file_path)
+	string ModelImporter::GetImportSettings() const
+	{
+		return
+			"assimp="		+ Settings::Get().m_versionAssimp +
+			";flags="		+ to_string(_ModelImporter::flags) +
+			";normals="		+ to_string(_ModelImporter::max_normal_smoothing_angle) +
+			";tangents="	+ to_string(_ModelImporter::max_tangent_smoothing_angle) +
+			";triangles="	+ to_string(_ModelImporter::triangle_limit) +
+			";vertices="	+ to_string(_ModelImporter::vertex_limit);
+	}
+
+	bool ModelImporter::Load(shared_ptr<Model> model, const string& file_path, vector<string>* dependencies)
 	{
 		if (!m_context)
 		{
@@ -89,19 +103,20 @@ namespace Directus
 		}
 
 		_ModelImporter::m_model_path = file_path;
+		_ModelImporter::m_dependencies.clear();
 
 		// Set up an Assimp importer
 		Importer importer;	
+		// Track the files it reads
+		importer.SetIOHandler(new AssimpHelper::AssimpIOSystem(&_ModelImporter::m_dependencies));
 		// Set normal smoothing angle
 		importer.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, _ModelImporter::max_normal_smoothing_angle);
 		// Set tangent smoothing angle
 		importer.SetPropertyFloat(AI_CONFIG_PP_CT_MAX_SMOOTHING_ANGLE, _ModelImporter::max_tangent_smoothing_angle);	
 		// Maximum number of triangles in a mesh (before splitting)
-		const unsigned int triangle_limit = 1000000;
-		importer.SetPropertyInteger(AI_CONFIG_PP_SLM_TRIANGLE_LIMIT, triangle_limit);
+		importer.SetPropertyInteger(AI_CONFIG_PP_SLM_TRIANGLE_LIMIT, _ModelImporter::triangle_limit);
 		// Maximum number of vertices in a mesh (before splitting)
-		const unsigned int vertex_limit = 1000000;
-		importer.SetPropertyInteger(AI_CONFIG_PP_SLM_VERTEX_LIMIT, vertex_limit);
+		importer.SetPropertyInteger(AI_CONFIG_PP_SLM_VERTEX_LIMIT, _ModelImporter::vertex_limit);
 		// Remove points and lines.
 		importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_LINE | aiPrimitiveType_POINT);	
 		// Remove cameras and lights
@@ -118,7 +133,11 @@ namespace Directus
 		if (result)
 		{
 			FIRE_EVENT(Event_World_Stop);
-			ReadNodeHierarchy(scene, scene->mRootNode, model);
+			{
+				// Announce all the new entities at once, when the hierarchy is complete
+				World::BatchScope batch(m_world);
+				ReadNodeHierarchy(scene, scene->mRootNode, model);
+			}
 			ReadAnimations(scene, model);
 			model->GeometryUpdate();
 			FIRE_EVENT(Event_World_Start);
@@ -130,6 +149,18 @@ namespace Directus
 
 		importer.FreeScene();
 
+		if (dependencies)
+		{
+			for (const auto& dependency : _ModelImporter::m_dependencies)
+			{
+				const auto path = FileSystem::GetRelativeFilePath(dependency);
+				if (path != FileSystem::GetRelativeFilePath(file_path) && find(dependencies->begin(), dependencies->end(), path) == dependencies->end())
+				{
+					dependencies->emplace_back(path);
+				}
+			}
+		}
+
 		return result;
 	}
 
@@ -408,6 +439,7 @@ namespace Directus
 					if (FileSystem::IsSupportedImageFile(deduced_path))
 					{
 						model->AddTexture(material, engine_tex, AssimpHelper::texture_validate_path(texture_path.data, _ModelImporter::m_model_path));
+						_ModelImporter::m_dependencies.emplace_back(deduced_path);
 					}
 
 					if (assimp_tex == aiTextureType_DIFFUSE)
@@ -47,7 +47,11 @@ namespace Directus
 		ModelImporter(Context* context);
 		~ModelImporter() = default;
 
-		bool Load(std::shared_ptr<Model> model, const std::string& file_path);
+		// The files the import read, besides file_path (material libraries, textures), are added to dependencies
+		bool Load(std::shared_ptr<Model> model, const std::string& file_path, std::vector<std::string>* dependencies = nullptr);
+
+		// Everything that affects the result of an import, for the import cache
+		std::string GetImportSettings() const;
 
 	private:
 		// PROCESSING
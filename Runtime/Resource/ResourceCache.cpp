@@ -19,11 +19,17 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES ===================
+//= INCLUDES =========================
 #include "ResourceCache.h"
+#include <algorithm>
+#include <unordered_set>
 #include "../World/Entity.h"
-#include "../Core/EventSystem.h"
-//==============================
+#include "../Threading/Threading.h"
+#include "../FileSystem/FileWatcher.h"
+#include "../Rendering/Renderer.h"
+#include "../Rendering/Material.h"
+#include "../World/World.h"
+//====================================
 
 //= NAMESPACES ================
 using namespace std;
@@ -32,6 +38,12 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace
+	{
+		// How often the memory budgets are enforced
+		const float g_residency_interval_sec = 1.0f;
+	}
+
 	ResourceCache::ResourceCache(Context* context) : ISubsystem(context)
 	{
 		string data_dir = GetDataDirectory();
@@ -48,23 +60,244 @@ namespace Directus
 		// Create project directory
 		SetProjectDirectory("Project//");
 
-		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Unload, EVENT_HANDLER(Clear));
+		// Memory budgets, textures and models are unloaded when over them, other types are unlimited
+		m_memory_budgets[Resource_Texture]	= 1024ull * 1024 * 1024;
+		m_memory_budgets[Resource_Model]	= 512ull * 1024 * 1024;
+
 	}
 
 	ResourceCache::~ResourceCache()
 	{
-		// Unsubscribe from event
-		UNSUBSCRIBE_FROM_EVENT(Event_World_Unload, EVENT_HANDLER(Clear));
 		Clear();
 	}
 
+	void ResourceCache::Tick()
+	{
+		// Hot reload, one shader change is enough to compile all of them again
+		if (m_file_watcher)
+		{
+			auto shaders_changed = false;
+			for (const auto& file_path : m_file_watcher->Poll())
+			{
+				// Directory listings see the change right away, removed files have nothing to reload
+				FileSystem::InvalidateDirectoryCache(file_path);
+				if (!FileSystem::FileExists(file_path))
+					continue;
+
+				const auto file_path_relative = FileSystem::GetRelativeFilePath(file_path);
+				if (FileSystem::IsSupportedShaderFile(file_path_relative))
+				{
+					shaders_changed = true;
+				}
+				else
+				{
+					Reload(file_path_relative);
+				}
+			}
+
+			if (shaders_changed)
+			{
+				LOG_INFO("Shaders changed, compiling them again...");
+				m_context->GetSubsystem<Renderer>()->ReloadShaders();
+			}
+		}
+
+		// Textures which finished reloading are swapped in between frames, so they are never rendered half way
+		{
+			lock_guard<mutex> lock(m_reloaded_mutex);
+			for (const auto& reloaded : m_textures_reloaded)
+			{
+				reloaded.first->Swap(*reloaded.second);
+			}
+			m_textures_reloaded.clear();
+		}
+
+		// Residency is checked a few times per second, it walks every resource
+		m_residency_timer += m_delta_time_sec;
+		if (m_residency_timer < g_residency_interval_sec)
+			return;
+		m_residency_timer = 0.0f;
+
+		// Destroyed after the lock is released
+		vector<shared_ptr<IResource>> evicted;
+
+		unique_lock<shared_mutex> lock(m_mutex);
+		const uint64_t tick = ++m_residency_tick;
+
+		// Materials aren't budgeted and stay cached, holding on to their textures. A texture only counts as used
+		// if something other than those idle materials references it, and unloading it unloads them too.
+		unordered_map<const IResource*, vector<shared_ptr<IResource>*>> idle_materials;
+		const auto materials = m_resource_groups.find(Resource_Material);
+		if (materials != m_resource_groups.end())
+		{
+			for (auto& resource : materials->second.resources)
+			{
+				if (!resource || resource.use_count() > 1 || resource->GetLoadState() != LoadState_Completed || !FileSystem::FileExists(resource->GetResourceFilePath()))
+					continue;
+
+				for (const auto& texture_slot : static_cast<Material*>(resource.get())->GetTextureSlots())
+				{
+					if (texture_slot.ptr)
+					{
+						idle_materials[texture_slot.ptr.get()].emplace_back(&resource);
+					}
+				}
+			}
+		}
+
+		for (auto& group : m_resource_groups)
+		{
+			const auto budget	= m_memory_budgets.find(group.first);
+			const auto limited	= budget != m_memory_budgets.end() && budget->second != 0;
+
+			uint64_t resident = 0;
+			vector<shared_ptr<IResource>*> unused;
+			for (auto& resource : group.second.resources)
+			{
+				if (!resource || resource->GetLoadState() == LoadState_Started)
+					continue;
+
+				// Anything but the cache holding it (an entity, a material in use, a model) counts as a use
+				const auto idle = idle_materials.find(resource.get());
+				const auto uses = resource.use_count() - (idle != idle_materials.end() ? static_cast<long>(idle->second.size()) : 0);
+				if (uses > 1)
+				{
+					resource->SetLastUsed(tick);
+				}
+				else if (limited && resource->HasFilePath())
+				{
+					unused.emplace_back(&resource);
+				}
+
+				resident += resource->GetMemoryUsage();
+			}
+
+			// Over budget, unload unused resources, least recently used first
+			if (limited && resident > budget->second)
+			{
+				sort(unused.begin(), unused.end(), [](const shared_ptr<IResource>* a, const shared_ptr<IResource>* b) { return (*a)->GetLastUsed() < (*b)->GetLastUsed(); });
+				for (const auto slot : unused)
+				{
+					if (resident <= budget->second)
+						break;
+
+					// Only what can be loaded again is unloaded
+					if (!FileSystem::FileExists((*slot)->GetResourceFilePath()))
+						continue;
+
+					resident -= min<uint64_t>(resident, (*slot)->GetMemoryUsage());
+
+					// Otherwise they keep it in memory, loading them again loads it again
+					const auto idle = idle_materials.find(slot->get());
+					if (idle != idle_materials.end())
+					{
+						for (const auto material : idle->second)
+						{
+							if (*material)
+							{
+								evicted.emplace_back(move(*material));
+							}
+						}
+					}
+
+					// The slot (and its name/path indices) stays, loading the resource again fills it
+					evicted.emplace_back(move(*slot));
+				}
+			}
+
+			m_memory_resident[group.first] = resident;
+		}
+	}
+
+	void ResourceCache::Reload(const string& file_path)
+	{
+		// Imported textures and import records are the engine's own output, reloading them would save them again
+		if (FileSystem::IsEngineTextureFile(file_path) || FileSystem::IsEngineMetadataFile(file_path))
+			return;
+
+		// Textures are imported again on the job system, the import is saved so that later loads pick the change up too
+		if (FileSystem::IsSupportedImageFile(file_path))
+		{
+			const auto texture_path = FileSystem::GetFilePathWithoutExtension(file_path) + EXTENSION_TEXTURE;
+			auto texture			= GetByPath<RHI_Texture>(file_path);
+			texture					= texture ? texture : GetByPath<RHI_Texture>(texture_path);
+			if (!texture || texture->GetLoadState() == LoadState_Started)
+				return;
+
+			LOGF_INFO("\"%s\" changed, reloading it...", file_path.c_str());
+			m_context->GetSubsystem<Threading>()->AddTask([this, texture, file_path, texture_path]()
+			{
+				auto reloaded = make_shared<RHI_Texture>(m_context);
+				if (!reloaded->LoadFromFile(file_path))
+					return;
+
+				reloaded->SaveToFile(texture_path);
+				reloaded->ClearTextureBytes();
+
+				lock_guard<mutex> lock(m_reloaded_mutex);
+				m_textures_reloaded.emplace_back(static_pointer_cast<RHI_Texture>(texture), reloaded);
+			});
+			return;
+		}
+
+		// Materials are small, they are loaded again in place
+		if (FileSystem::IsEngineMaterialFile(file_path))
+		{
+			const auto material = static_pointer_cast<Material>(GetByPath<Material>(file_path));
+			if (!material || material->GetLoadState() == LoadState_Started)
+				return;
+
+			LOGF_INFO("\"%s\" changed, reloading it...", file_path.c_str());
+
+			// Loading only assigns the textures the file lists, the ones it no longer lists have to go
+			for (auto type = static_cast<int>(TextureType_Unknown); type <= static_cast<int>(TextureType_Mask); type++)
+			{
+				material->SetTextureSlot(static_cast<TextureType>(type), nullptr);
+			}
+
+			// A change in transparency is reported by the material itself
+			material->LoadFromFile(file_path);
+			return;
+		}
+
+		// Scripts are compiled by the scripting engine, which isn't thread safe
+		if (FileSystem::IsEngineScriptFile(file_path))
+		{
+			LOGF_INFO("\"%s\" changed, reloading it...", file_path.c_str());
+			m_context->GetSubsystem<World>()->EntitiesReloadScripts(file_path);
+		}
+	}
+
+	void ResourceCache::SetMemoryBudget(const Resource_Type type, const uint64_t bytes)
+	{
+		unique_lock<shared_mutex> lock(m_mutex);
+		m_memory_budgets[type] = bytes;
+	}
+
+	uint64_t ResourceCache::GetMemoryBudget(const Resource_Type type)
+	{
+		shared_lock<shared_mutex> lock(m_mutex);
+		const auto budget = m_memory_budgets.find(type);
+		return budget != m_memory_budgets.end() ? budget->second : 0;
+	}
+
+	uint64_t ResourceCache::GetMemoryResident(const Resource_Type type)
+	{
+		shared_lock<shared_mutex> lock(m_mutex);
+		const auto resident = m_memory_resident.find(type);
+		return resident != m_memory_resident.end() ? resident->second : 0;
+	}
+
 	bool ResourceCache::Initialize()
 	{
 		// Importers
 		m_importer_image	= make_shared<ImageImporter>(m_context);
 		m_importer_model	= make_shared<ModelImporter>(m_context);
 		m_importer_font		= make_shared<FontImporter>(m_context);
+
+		// Hot reload
+		WatchDirectories();
+
 		return true;
 	}
 
@@ -76,68 +309,220 @@ namespace Directus
 			return false;
 		}
 
-		for (const auto& resource : m_resource_groups[resource_type])
+		shared_lock<shared_mutex> lock(m_mutex);
+		return Find(resource_name, resource_type) != nullptr;
+	}
+
+	shared_ptr<IResource> ResourceCache::GetByName(const string& name, const Resource_Type type)
+	{
+		shared_lock<shared_mutex> lock(m_mutex);
+		auto& resource = Find(name, type);
+		if (resource)
 		{
-			if (resource_name == resource->GetResourceName())
-				return true;
+			resource->SetLastUsed(m_residency_tick);
 		}
+		return resource;
+	}
 
-		return false;
+	shared_ptr<IResource>& ResourceCache::Find(const string& name, const Resource_Type type)
+	{
+		const auto group = m_resource_groups.find(type);
+		if (group == m_resource_groups.end())
+			return m_empty_resource;
+
+		const auto resource = group->second.by_name.find(name);
+		return resource != group->second.by_name.end() ? *resource->second : m_empty_resource;
+	}
+
+	void ResourceCache::AddPath(const string& path, const shared_ptr<IResource>& resource)
+	{
+		unique_lock<shared_mutex> lock(m_mutex);
+		auto& group		= m_resource_groups[resource->GetResourceType()];
+		auto& cached	= Find(resource->GetResourceName(), resource->GetResourceType());
+		if (cached == resource)
+		{
+			group.by_path.emplace(path, &cached);
+		}
 	}
 
-	shared_ptr<IResource>& ResourceCache::GetByName(const string& name, const Resource_Type type)
+	void ResourceCache::Wait(const shared_ptr<IResource>& resource)
 	{
-		for (auto& resource : m_resource_groups[type])
+		if (!resource)
+			return;
+
+		shared_ptr<LoadJob> job;
+		{
+			lock_guard<mutex> lock(m_in_flight_mutex);
+			const auto it = m_in_flight.find(resource.get());
+			if (it == m_in_flight.end())
+				return;
+			job = it->second;
+		}
+
+		// Requested again while loading it (e.g. a model's prefab referencing the model), waiting would never return
+		if (job->claimed && job->thread == this_thread::get_id())
+			return;
+
+		// Does nothing if another thread is already loading it
+		Run(job);
+
+		unique_lock<mutex> lock(m_in_flight_mutex);
+		m_in_flight_condition.wait(lock, [&job]() { return job->done; });
+	}
+
+	shared_ptr<ResourceCache::LoadJob> ResourceCache::Track(const shared_ptr<IResource>& resource, vector<string> paths)
+	{
+		auto job		= make_shared<LoadJob>();
+		job->resource	= resource;
+		job->paths		= move(paths);
+
+		lock_guard<mutex> lock(m_in_flight_mutex);
+		m_in_flight[resource.get()] = job;
+		return job;
+	}
+
+	void ResourceCache::Untrack(const shared_ptr<LoadJob>& job)
+	{
+		{
+			lock_guard<mutex> lock(m_in_flight_mutex);
+			job->done = true;
+			m_in_flight.erase(job->resource.get());
+		}
+		m_in_flight_condition.notify_all();
+	}
+
+	void ResourceCache::Queue(const shared_ptr<LoadJob>& job)
+	{
+		m_context->GetSubsystem<Threading>()->AddTask([this, job]() { Run(job); });
+	}
+
+	void ResourceCache::Run(const shared_ptr<LoadJob>& job)
+	{
+		// Whoever gets here first loads it, the job system or a thread waiting on it
+		if (job->claimed.exchange(true))
+			return;
+		job->thread = this_thread::get_id();
+
+		const auto& resource	= job->resource;
+		const auto loaded		= resource->LoadFromFile(resource->GetResourceFilePath());
+		if (loaded)
+		{
+			for (const auto& path : job->paths)
+			{
+				AddPath(path, resource);
+			}
+		}
+		else
 		{
-			if (name == resource->GetResourceName())
-				return resource;
+			LOGF_ERROR("Failed to load \"%s\".", resource->GetResourceFilePath().c_str());
+
+			// Forgotten, so that the next request tries again (the emptied slot is reused)
+			unique_lock<shared_mutex> lock(m_mutex);
+			auto& group = m_resource_groups[resource->GetResourceType()];
+			// By value, LoadFromFile() might have renamed it before failing
+			const auto slot = find_if(group.by_name.begin(), group.by_name.end(), [&resource](const auto& entry) { return *entry.second == resource; });
+			if (slot != group.by_name.end())
+			{
+				const auto cached = slot->second;
+				for (auto it = group.by_path.begin(); it != group.by_path.end();)
+				{
+					it = it->second == cached ? group.by_path.erase(it) : next(it);
+				}
+				group.by_name.erase(slot);
+				cached->reset();
+				group.slots_free.emplace_back(cached);
+			}
 		}
+		resource->SetLoadState(loaded ? LoadState_Completed : LoadState_Failed);
 
-		return m_empty_resource;
+		Untrack(job);
 	}
 
 	vector<shared_ptr<IResource>> ResourceCache::GetByType(const Resource_Type type /*= Resource_Unknown*/)
 	{
 		vector<shared_ptr<IResource>> resources;
 
+		shared_lock<shared_mutex> lock(m_mutex);
 		if (type == Resource_Unknown)
 		{
-			for (const auto& resource_group : m_resource_groups)
+			for (const auto& group : m_resource_groups)
 			{
-				resources.insert(resources.end(), resource_group.second.begin(), resource_group.second.end());
+				resources.insert(resources.end(), group.second.resources.begin(), group.second.resources.end());
 			}
 		}
 		else
 		{
-			resources = m_resource_groups[type];
+			const auto group = m_resource_groups.find(type);
+			if (group != m_resource_groups.end())
+			{
+				resources.assign(group->second.resources.begin(), group->second.resources.end());
+			}
 		}
 
+		// Evicted resources leave an empty slot behind
+		resources.erase(remove(resources.begin(), resources.end(), nullptr), resources.end());
+
 		return resources;
 	}
 
-	unsigned int ResourceCache::GetMemoryUsage(Resource_Type type /*= Resource_Unknown*/)
+	unsigned int ResourceCache::Sweep()
 	{
-		unsigned int size = 0;
+		unsigned int count = 0;
 
-		if (type = Resource_Unknown)
+		// Releasing a resource can leave others unreferenced (a model's materials, a material's textures),
+		// so it repeats until nothing else is released. Resources are destroyed outside of the lock.
+		vector<shared_ptr<IResource>> released;
+		do
 		{
-			for (const auto& group : m_resource_groups)
+			released.clear();
+
+			unique_lock<shared_mutex> lock(m_mutex);
+			for (auto& group : m_resource_groups)
 			{
-				for (const auto& resource : group.second)
+				unordered_set<shared_ptr<IResource>*> slots;
+				for (auto& resource : group.second.resources)
 				{
-					if (!resource)
-						continue;
-
-					size += resource->GetMemoryUsage();
+					// Loads in flight hold a reference, so anything still loading is kept. So is anything that can't be loaded again.
+					if (resource && resource.use_count() == 1 && resource->HasFilePath())
+					{
+						released.emplace_back(move(resource));
+						slots.emplace(&resource);
+					}
 				}
+				if (slots.empty())
+					continue;
+
+				// Nothing refers to the emptied slots anymore, they are reused by what's cached next
+				auto unindex = [&slots](unordered_map<string, shared_ptr<IResource>*>& index)
+				{
+					for (auto it = index.begin(); it != index.end();)
+					{
+						it = slots.count(it->second) ? index.erase(it) : next(it);
+					}
+				};
+				unindex(group.second.by_name);
+				unindex(group.second.by_path);
+				group.second.slots_free.insert(group.second.slots_free.end(), slots.begin(), slots.end());
 			}
+			lock.unlock();
+
+			count += static_cast<unsigned int>(released.size());
+		} while (!released.empty());
+
+		if (count != 0)
+		{
+			LOGF_INFO("Released %d unused resources.", count);
 		}
-		else
+
+		return count;
+	}
+
+	unsigned int ResourceCache::GetMemoryUsage(const Resource_Type type /*= Resource_Unknown*/)
+	{
+		unsigned int size = 0;
+		for (const auto& resource : GetByType(type))
 		{
-			for (const auto& resource : m_resource_groups[type])
-			{
-				size += resource->GetMemoryUsage();
-			}
+			size += resource->GetMemoryUsage();
 		}
 
 		return size;
@@ -145,26 +530,21 @@ namespace Directus
 
 	void ResourceCache::GetResourceFilePaths(std::vector<std::string>& file_paths)
 	{
-		for (const auto& resource_group : m_resource_groups)
+		for (const auto& resource : GetByType())
 		{
-			for (const auto& resource : resource_group.second)
-			{
-				file_paths.emplace_back(resource->GetResourceFilePath());
-			}
+			file_paths.emplace_back(resource->GetResourceFilePath());
 		}
 	}
 
 	void ResourceCache::SaveResourcesToFiles()
 	{
-		for (const auto& resource_group : m_resource_groups)
+		// Saving can cache other resources, so it works on a copy
+		for (const auto& resource : GetByType())
 		{
-			for (const auto& resource : resource_group.second)
-			{
-				if (!resource->HasFilePath())
-					continue;
+			if (!resource->HasFilePath())
+				continue;
 
-				resource->SaveToFile(resource->GetResourceFilePath());
-			}
+			resource->SaveToFile(resource->GetResourceFilePath());
 		}
 	}
 
@@ -197,6 +577,18 @@ namespace Directus
 		}
 
 		m_project_directory = directory;
+
+		// Not watching anything before initialization
+		if (m_file_watcher)
+		{
+			WatchDirectories();
+		}
+	}
+
+	void ResourceCache::WatchDirectories()
+	{
+		m_file_watcher.reset();
+		m_file_watcher = make_unique<FileWatcher>(vector<string>{ m_project_directory, GetDataDirectory(Asset_Shaders) });
 	}
 
 	string ResourceCache::GetProjectDirectoryAbsolute() const
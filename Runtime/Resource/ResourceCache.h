@@ -24,6 +24,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <memory>
 #include <map>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <shared_mutex>
 #include "Import/ModelImporter.h"
 #include "Import/ImageImporter.h"
 #include "Import/FontImporter.h"
@@ -34,6 +41,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace Directus
 {
+	class FileWatcher;
+
 	#define VALIDATE_RESOURCE_TYPE(T) static_assert(std::is_base_of<IResource, T>::value, "Provided type does not implement IResource")
 
 	enum Asset_Type
@@ -55,11 +64,12 @@ namespace Directus
 
 		//= Subsystem =============
 		bool Initialize() override;
+		void Tick() override;
 		//=========================
 
 		//= GET BY ==================================================================================
 		// NAME
-		std::shared_ptr<IResource>& GetByName(const std::string& name, Resource_Type type);
+		std::shared_ptr<IResource> GetByName(const std::string& name, Resource_Type type);
 		template <class T> 
 		constexpr std::shared_ptr<T> GetByName(const std::string& name) 
 		{ 
@@ -69,19 +79,23 @@ namespace Directus
 
 		// TYPE
 		std::vector<std::shared_ptr<IResource>> GetByType(Resource_Type type = Resource_Unknown);
-		// PATH
+		// PATH (the path a resource was cached with, or any path it was loaded from)
 		template <class T>
-		std::shared_ptr<IResource>& GetByPath(const std::string& path)
+		std::shared_ptr<IResource> GetByPath(const std::string& path)
 		{
 			VALIDATE_RESOURCE_TYPE(T);
 
-			for (auto& resource : m_resource_groups[IResource::TypeToEnum<T>()])
-			{
-				if (path == resource->GetResourceFilePath())
-					return resource;
-			}
+			std::shared_lock<std::shared_mutex> lock(m_mutex);
+			const auto group = m_resource_groups.find(IResource::TypeToEnum<T>());
+			if (group == m_resource_groups.end())
+				return nullptr;
+
+			const auto resource = group->second.by_path.find(path);
+			if (resource == group->second.by_path.end() || !*resource->second)
+				return nullptr;
 
-			return m_empty_resource;
+			(*resource->second)->SetLastUsed(m_residency_tick);
+			return *resource->second;
 		}
 		//===========================================================================================
 	
@@ -95,60 +109,69 @@ namespace Directus
 			if (!resource)
 				return;
 
+			// Checking and adding happen under the same lock, so concurrent loads of the same resource end up with one instance
+			std::unique_lock<std::shared_mutex> lock(m_mutex);
+			auto& group = m_resource_groups[resource->GetResourceType()];
+
 			// If the resource is already loaded, replace it with the existing one, then early exit
-			if (IsCached(resource->GetResourceName(), resource->GetResourceType()))
+			const auto existing = group.by_name.find(resource->GetResourceName());
+			if (existing != group.by_name.end())
 			{
-				resource = GetByName<T>(FileSystem::GetFileNameNoExtensionFromFilePath(resource->GetResourceFilePath()));
+				if (*existing->second)
+				{
+					resource = std::static_pointer_cast<T>(*existing->second);
+					return;
+				}
+
+				// It was evicted, it takes its old slot back
+				*existing->second = resource;
+				resource->SetLastUsed(m_residency_tick);
+				if (resource->HasFilePath())
+				{
+					group.by_path.emplace(resource->GetResourceFilePath(), existing->second);
+				}
 				return;
 			}
 
-			// Cache the resource
-			std::lock_guard<mutex> guard(m_mutex);
-			m_resource_groups[resource->GetResourceType()].emplace_back(resource);
-		}
-		bool IsCached(const std::string& resource_name, Resource_Type resource_type);
-
-		// Loads a resource and adds it to the resource cache
-		template <class T>
-		std::shared_ptr<T> Load(const std::string& file_path)
-		{
-			VALIDATE_RESOURCE_TYPE(T);
-
-			if (!FileSystem::FileExists(file_path))
+			// Cache the resource, in a slot nothing indexes anymore if there is one
+			std::shared_ptr<IResource>* cached;
+			if (!group.slots_free.empty())
 			{
-				LOGF_ERROR("Path \"%s\" is invalid.", file_path.c_str());
-				return false;
+				cached = group.slots_free.back();
+				group.slots_free.pop_back();
+				*cached = resource;
 			}
-
-			// Try to make the path relative to the engine (in case it isn't)
-			auto file_path_relative	= FileSystem::GetRelativeFilePath(file_path);
-			auto name				= FileSystem::GetFileNameNoExtensionFromFilePath(file_path_relative);
-
-			// Check if the resource is already loaded
-			if (IsCached(name, IResource::TypeToEnum<T>()))
+			else
 			{
-				return GetByName<T>(name);
+				cached = &group.resources.emplace_back(resource);
 			}
+			group.by_name.emplace(resource->GetResourceName(), cached);
+			if (resource->HasFilePath())
+			{
+				group.by_path.emplace(resource->GetResourceFilePath(), cached);
+			}
+		}
+		bool IsCached(const std::string& resource_name, Resource_Type resource_type);
 
-			// Create new resource
-			auto typed = std::make_shared<T>(m_context);
-			// Set a default name and a default filepath in case it's not overridden by LoadFromFile()
-			typed->SetResourceName(name);
-			typed->SetResourceFilePath(file_path_relative);
-
-			// Cache it now so LoadFromFile() can safely pass around a reference to the resource from the ResourceManager
-			Cache<T>(typed);
+		// Starts loading a resource on the job system and returns it straight away, it can be referenced while it loads.
+		// Its LoadState tells when it's done, Wait() blocks until then. Requests for a resource which is already loading return that resource.
+		template <class T>
+		std::shared_ptr<T> LoadAsync(const std::string& file_path) { return Request<T>(file_path, true); }
 
-			// Load
-			if (!typed->LoadFromFile(file_path_relative))
-			{
-				LOGF_ERROR("Failed to load \"%s\".", file_path_relative.c_str());
+		// Loads a resource and adds it to the resource cache, if it's already loading (e.g. from LoadAsync), it waits for it instead
+		template <class T>
+		std::shared_ptr<T> Load(const std::string& file_path)
+		{
+			auto resource = Request<T>(file_path, false);
+			if (!resource)
 				return nullptr;
-			}
 
-			// Cache it and cast it
-			return typed;
+			Wait(resource);
+			return resource->GetLoadState() != LoadState_Failed ? resource : nullptr;
 		}
+
+		// Blocks until the resource is loaded, if nobody has started loading it yet, it's loaded on the calling thread
+		void Wait(const std::shared_ptr<IResource>& resource);
 		//===============================================================================================================
 
 		//= I/O ========================================================
@@ -159,12 +182,23 @@ namespace Directus
 		//= MISC ==========================================================
 		// Memory
 		unsigned int GetMemoryUsage(Resource_Type type = Resource_Unknown);
+		// Releases the resources which nothing else (an entity, another resource) holds and can be loaded again, returns how many
+		unsigned int Sweep();
 		// Unloads all resources
-		void Clear() { m_resource_groups.clear(); }
+		void Clear() { std::unique_lock<std::shared_mutex> lock(m_mutex); m_resource_groups.clear(); m_memory_resident.clear(); }
 		// Returns all resources of a given type
 		unsigned int GetResourceCountByType(Resource_Type type);
 		//=================================================================
 
+		//= MEMORY BUDGETS =========================================================================================
+		// When the resources of a type use more than its budget, those nothing else references are unloaded,
+		// least recently used first, and loaded again the next time they are requested. A budget of 0 is unlimited.
+		void SetMemoryBudget(Resource_Type type, uint64_t bytes);
+		uint64_t GetMemoryBudget(Resource_Type type);
+		// Memory used by the resources of a type, as of the last budget check
+		uint64_t GetMemoryResident(Resource_Type type);
+		//==========================================================================================================
+
 		//= DIRECTORIES ===============================================================
 		void AddDataDirectory(Asset_Type type, const std::string& directory);
 		const std::string& GetDataDirectory(Asset_Type type);
@@ -180,9 +214,113 @@ namespace Directus
 		FontImporter* GetFontImporter() const	{ return m_importer_font.get(); }
 
 	private:
-		// Cache
-		std::map<Resource_Type, std::vector<std::shared_ptr<IResource>>> m_resource_groups;
-		std::mutex m_mutex;
+		// Expects m_mutex to be locked (shared is enough)
+		std::shared_ptr<IResource>& Find(const std::string& name, Resource_Type type);
+		// Makes a cached resource findable by another path it was loaded from
+		void AddPath(const std::string& path, const std::shared_ptr<IResource>& resource);
+		// Hot reload, the path is a (relative) file which changed on disk
+		void WatchDirectories();
+		void Reload(const std::string& file_path);
+
+		// Returns the resource for a path, creating, caching and queuing a load for it if needed
+		template <class T>
+		std::shared_ptr<T> Request(const std::string& file_path, const bool async)
+		{
+			VALIDATE_RESOURCE_TYPE(T);
+
+			// Loaded (or loading) from this exact path before, skips touching the file system and normalizing the path
+			if (const auto& cached = GetByPath<T>(file_path))
+				return std::static_pointer_cast<T>(cached);
+
+			if (!FileSystem::FileExists(file_path))
+			{
+				LOGF_ERROR("Path \"%s\" is invalid.", file_path.c_str());
+				return nullptr;
+			}
+
+			// Try to make the path relative to the engine (in case it isn't)
+			auto file_path_relative	= FileSystem::GetRelativeFilePath(file_path);
+			auto name				= FileSystem::GetFileNameNoExtensionFromFilePath(file_path_relative);
+
+			// Check if the resource is already loaded
+			if (auto cached = GetByName<T>(name))
+			{
+				AddPath(file_path, cached);
+				return cached;
+			}
+
+			// Create new resource, whatever is cheap to read (e.g. texture properties) is read now, before anyone can see it
+			auto typed = std::make_shared<T>(m_context);
+			typed->LoadMetadata(file_path_relative);
+			// Set a default name and a default filepath in case it's not overridden by LoadFromFile()
+			typed->SetResourceName(name);
+			typed->SetResourceFilePath(file_path_relative);
+			typed->SetLoadState(LoadState_Started);
+
+			// Track the load before caching, so anyone who finds the resource in the cache can wait for it
+			auto job = Track(typed, { file_path, file_path_relative });
+
+			// Cache it now so LoadFromFile() can safely pass around a reference to the resource from the ResourceManager
+			auto cached = typed;
+			Cache<T>(cached);
+
+			// Another thread cached it first, it's loading (or loaded) it
+			if (cached != typed)
+			{
+				Untrack(job);
+				return cached;
+			}
+
+			// A synchronous load is run by the Wait() that follows
+			if (async)
+			{
+				Queue(job);
+			}
+
+			return typed;
+		}
+
+		// A resource which is loading, anyone waiting on it runs it if no thread has picked it up yet
+		struct LoadJob
+		{
+			std::shared_ptr<IResource> resource;
+			std::vector<std::string> paths; // the resource becomes findable by these once loaded
+			std::atomic<bool> claimed = false;
+			std::atomic<std::thread::id> thread;
+			bool done = false; // guarded by m_in_flight_mutex
+		};
+		std::shared_ptr<LoadJob> Track(const std::shared_ptr<IResource>& resource, std::vector<std::string> paths);
+		void Untrack(const std::shared_ptr<LoadJob>& job);
+		void Queue(const std::shared_ptr<LoadJob>& job);
+		void Run(const std::shared_ptr<LoadJob>& job);
+
+		// Resources are stored in a deque, so that references to them survive other resources being cached (from other threads),
+		// and are indexed by the name and path they were cached with. Lookups only take a shared lock, caching an exclusive one.
+		struct ResourceGroup
+		{
+			std::deque<std::shared_ptr<IResource>> resources;
+			std::unordered_map<std::string, std::shared_ptr<IResource>*> by_name;
+			std::unordered_map<std::string, std::shared_ptr<IResource>*> by_path;
+			std::vector<std::shared_ptr<IResource>*> slots_free; // empty and not indexed, reused by the next resource cached
+		};
+		std::unordered_map<Resource_Type, ResourceGroup> m_resource_groups;
+		std::shared_mutex m_mutex;
+
+		// Residency, guarded by m_mutex (the tick is also read under a shared lock)
+		std::unordered_map<Resource_Type, uint64_t> m_memory_budgets;
+		std::unordered_map<Resource_Type, uint64_t> m_memory_resident;
+		std::atomic<uint64_t> m_residency_tick = 0;
+		float m_residency_timer = 0.0f;
+
+		// Loads in flight, by resource
+		std::unordered_map<IResource*, std::shared_ptr<LoadJob>> m_in_flight;
+		std::mutex m_in_flight_mutex;
+		std::condition_variable m_in_flight_condition;
+
+		// Hot reload, textures are swapped in by Tick() once reloaded (live, reloaded)
+		std::unique_ptr<FileWatcher> m_file_watcher;
+		std::vector<std::pair<std::shared_ptr<RHI_Texture>, std::shared_ptr<RHI_Texture>>> m_textures_reloaded;
+		std::mutex m_reloaded_mutex;
 
 		// Directories
 		std::map<Asset_Type, std::string> m_standard_resource_directories;
@@ -94,4 +94,69 @@ namespace Directus
 			task->Execute();
 		}
 	}
+
+	void Threading::AddTaskLoop(const function<void(unsigned int start, unsigned int end)>& function, const unsigned int range)
+	{
+		if (range == 0)
+			return;
+
+		// One batch per worker thread plus one for the calling thread
+		const auto batch_count	= min(m_threadCount + 1, range);
+		const auto batch_size	= (range + batch_count - 1) / batch_count;
+		if (batch_count == 1)
+		{
+			function(0, range);
+			return;
+		}
+
+		// Batches are claimed rather than assigned, the calling thread keeps claiming until none are left and then only waits
+		// for those already running. So a loop issued from a worker (while every other worker is busy) can't wait on tasks
+		// stuck in the queue behind it. The state is shared since tasks that start after the loop has finished still touch it.
+		struct loop_state
+		{
+			std::function<void(unsigned int, unsigned int)> body;
+			unsigned int range;
+			unsigned int batch_count;
+			unsigned int batch_size;
+			atomic<unsigned int> batch_next	= 0;
+			unsigned int batches_done		= 0;
+			mutex done_mutex;
+			condition_variable done_condition;
+		};
+		auto state			= make_shared<loop_state>();
+		state->body			= function;
+		state->range		= range;
+		state->batch_count	= batch_count;
+		state->batch_size	= batch_size;
+
+		auto run = [state]()
+		{
+			unsigned int batch;
+			while ((batch = state->batch_next++) < state->batch_count)
+			{
+				const auto start	= batch * state->batch_size;
+				const auto end		= min(start + state->batch_size, state->range);
+				if (start < end)
+				{
+					state->body(start, end);
+				}
+
+				lock_guard<mutex> lock(state->done_mutex);
+				if (++state->batches_done == state->batch_count)
+				{
+					state->done_condition.notify_one();
+				}
+			}
+		};
+
+		for (unsigned int i = 1; i < batch_count; i++)
+		{
+			AddTask(run);
+		}
+		run();
+
+		// Wait for the batches other threads claimed
+		unique_lock<mutex> lock(state->done_mutex);
+		state->done_condition.wait(lock, [&state] { return state->batches_done == state->batch_count; });
+	}
 }
\ No newline at end of file
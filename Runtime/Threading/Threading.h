@@ -26,6 +26,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <thread>
 #include <mutex>
 #include <queue>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
 #include "../Core/ISubsystem.h"
 #include "../Logging/Log.h"
 //============================
@@ -79,6 +82,11 @@ namespace Directus
 			m_conditionVar.notify_one();
 		}
 
+		// Splits [0, range) into batches, executes them in parallel (the calling thread takes one) and waits for all of them to finish
+		void AddTaskLoop(const std::function<void(unsigned int start, unsigned int end)>& function, unsigned int range);
+
+		unsigned int GetThreadCount() const { return m_threadCount; }
+
 	private:
 		unsigned int m_threadCount;
 		std::vector<std::thread> m_threads;
@@ -38,6 +38,7 @@ namespace Directus
 		//= COMPONENT ===============
 		void OnInitialize() override;
 		void OnTick() override;
+		bool IsTickParallel() const override { return true; }
 		//===========================
 
 	private:
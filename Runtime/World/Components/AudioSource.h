@@ -43,6 +43,7 @@ namespace Directus
 		void OnStop() override;
 		void OnRemove() override;
 		void OnTick() override;
+		bool IsTickParallel() const override { return true; }
 		void Serialize(FileStream* stream) override;
 		void Deserialize(FileStream* stream) override;
 		//============================================
@@ -165,7 +165,7 @@ namespace Directus
 
 		// Trace ray
 		m_ray		= Ray(GetTransform()->GetPosition(), ScreenToWorldPoint(mouse_position_relative));
-		auto hits	= m_ray.Trace(m_context);
+		auto hits	= m_ray.Trace(m_context, Tag_Pickable);
 
 		// Get closest hit that doesn't start inside an entity
 		for (const auto& hit : hits)
@@ -53,6 +53,7 @@ namespace Directus
 		//= ICOMPONENT ===============================
 		void OnInitialize() override;
 		void OnTick() override;
+		bool IsTickParallel() const override { return true; }
 		void Serialize(FileStream* stream) override;
 		void Deserialize(FileStream* stream) override;
 		//============================================
@@ -94,6 +95,7 @@ namespace Directus
 		//= MISC ========================================================================
 		bool IsInViewFrustrum(Renderable* renderable);
 		bool IsInViewFrustrum(const Math::Vector3& center, const Math::Vector3& extents);
+		const Math::Frustum& GetFrustum() const			{ return m_frustrum; }
 		const Math::Vector4& GetClearColor() const		{ return m_clear_color; }
 		void SetClearColor(const Math::Vector4& color)	{ m_clear_color = color; }
 		//===============================================================================
@@ -54,6 +54,7 @@ namespace Directus
 		void OnInitialize() override;
 		void OnRemove() override;
 		void OnTick() override;
+		bool IsTickParallel() const override { return true; }
 		void Serialize(FileStream* stream) override;
 		void Deserialize(FileStream* stream) override;
 		//============================================
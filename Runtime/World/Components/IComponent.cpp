@@ -21,6 +21,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ===========================
 #include "IComponent.h"
+#include <mutex>
+#include <cstring>
+#include <typeindex>
+#include <unordered_map>
 #include "Light.h"
 #include "Skybox.h"
 #include "Script.h"
@@ -31,6 +35,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "AudioListener.h"
 #include "../Entity.h"
 #include "../../FileSystem/FileSystem.h"
+#include "../../Logging/Log.h"
 //======================================
 
 //= NAMESPACES =====
@@ -61,6 +66,70 @@ namespace Directus
 		return m_entity->GetName();
 	}
 
+	namespace
+	{
+		// One attribute table per component type
+		unordered_map<type_index, unique_ptr<vector<Attribute>>> g_attribute_tables;
+		mutex g_attribute_tables_mutex;
+		const vector<Attribute> g_attributes_empty;
+	}
+
+	const vector<Attribute>& IComponent::GetAttributes() const
+	{
+		return m_attributes ? *m_attributes : g_attributes_empty;
+	}
+
+	void IComponent::CopyAttributes(const IComponent* source)
+	{
+		if (!source || source->m_attributes != m_attributes)
+		{
+			LOG_ERROR("Can't copy attributes between components of a different type");
+			return;
+		}
+
+		if (!m_attributes)
+			return;
+
+		const auto from	= reinterpret_cast<const char*>(source);
+		const auto to	= reinterpret_cast<char*>(this);
+		for (const auto& attribute : *m_attributes)
+		{
+			if (attribute.set)
+			{
+				attribute.set(this, from + attribute.offset);
+			}
+			else if (attribute.copy)
+			{
+				attribute.copy(to + attribute.offset, from + attribute.offset);
+			}
+			else
+			{
+				memcpy(to + attribute.offset, from + attribute.offset, attribute.size);
+			}
+		}
+	}
+
+	void IComponent::RegisterAttribute(const Attribute& attribute)
+	{
+		// Called from the constructor of the derived component, so that's the type typeid() sees
+		lock_guard<mutex> lock(g_attribute_tables_mutex);
+		if (!m_attributes)
+		{
+			auto& table = g_attribute_tables[type_index(typeid(*this))];
+			if (!table)
+			{
+				table = make_unique<vector<Attribute>>();
+			}
+			m_attributes = table.get();
+		}
+
+		// Every instance registers the same attributes, in the same order, so the first one to get here adds it
+		if (m_attribute_count++ == m_attributes->size())
+		{
+			m_attributes->emplace_back(attribute);
+		}
+	}
+
 	template <typename T>
 	constexpr ComponentType IComponent::TypeToEnum() { return ComponentType_Unknown; }
 
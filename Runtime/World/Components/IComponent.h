@@ -24,9 +24,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =====================
 #include <memory>
 #include <string>
-#include <any>
 #include <vector>
-#include <functional>
+#include <typeinfo>
+#include <type_traits>
 #include "../../Core/EngineDefs.h"
 //================================
 
@@ -36,6 +36,7 @@ namespace Directus
 	class Transform;
 	class Context;
 	class FileStream;
+	class IComponent;
 
 	enum ComponentType : unsigned int
 	{
@@ -53,10 +54,16 @@ namespace Directus
 		ComponentType_Unknown
 	};
 
+	// Describes a member of a component. The table of a component type is shared by all of it's instances.
 	struct Attribute
 	{
-		std::function<std::any()> getter;
-		std::function<void(std::any)> setter;
+		unsigned int offset	= 0; // from the start of the component
+		unsigned int size	= 0;
+		size_t type_id		= 0;
+		// Used instead of memcpy for types which aren't trivially copyable
+		void (*copy)(void* destination, const void* source) = nullptr;
+		// Optional, receives the value instead of it being written to the member
+		void (*set)(IComponent* component, const void* value) = nullptr;
 	};
 
 	class ENGINE_CLASS IComponent
@@ -80,6 +87,9 @@ namespace Directus
 		// Runs every frame
 		virtual void OnTick() {}
 
+		// Components that only touch their own entity during OnTick() can be ticked on worker threads
+		virtual bool IsTickParallel() const { return false; }
+
 		// Runs when the entity is being saved
 		virtual void Serialize(FileStream* stream) {}
 
@@ -104,37 +114,38 @@ namespace Directus
 		constexpr ComponentType GetType() const	{ return m_type; }
 		void SetType(const ComponentType type)	{ m_type = type; }
 
-		const auto& GetAttributes() const { return m_attributes; }
-		void SetAttributes(const std::vector<Attribute>& attributes)
-		{ 
-			for (unsigned int i = 0; i < static_cast<unsigned int>(m_attributes.size()); i++)
-			{
-				m_attributes[i].setter(attributes[i].getter());
-			}
-		}
+		//= ATTRIBUTES ==========================================================================
+		const std::vector<Attribute>& GetAttributes() const;
+		// Copies the attributes of a component of the same type
+		void CopyAttributes(const IComponent* source);
 		//=======================================================================================
 
 	protected:
-		#define REGISTER_ATTRIBUTE_GET_SET(getter, setter, type) RegisterAttribute(		\
-		[this]()						{ return getter(); },							\
-		[this](const std::any& valueIn) { setter(std::any_cast<type>(valueIn)); });		\
-
-		#define REGISTER_ATTRIBUTE_VALUE_SET(value, setter, type) RegisterAttribute(	\
-		[this]()						{ return value; },								\
-		[this](const std::any& valueIn) { setter(std::any_cast<type>(valueIn)); });		\
+		#define REGISTER_ATTRIBUTE_VALUE_SET(value, setter, type)												\
+		{																										\
+			using component_type = std::remove_pointer_t<decltype(this)>;										\
+			RegisterAttribute<type>(value, [](IComponent* component, const void* data)							\
+			{ static_cast<component_type*>(component)->setter(*static_cast<const type*>(data)); });				\
+		}
 
-		#define REGISTER_ATTRIBUTE_VALUE_VALUE(value, type) RegisterAttribute(			\
-		[this]()						{ return value; },								\
-		[this](const std::any& valueIn) { value = std::any_cast<type>(valueIn); });		\
+		#define REGISTER_ATTRIBUTE_VALUE_VALUE(value, type) RegisterAttribute<type>(value)
 
-		// Registers an attribute
-		void RegisterAttribute(std::function<std::any()>&& getter, std::function<void(std::any)>&& setter)
-		{ 
+		// Registers an attribute (only the first instance of a component type fills the table)
+		template <typename T>
+		void RegisterAttribute(const T& value, void (*set)(IComponent*, const void*) = nullptr)
+		{
 			Attribute attribute;
-			attribute.getter = std::move(getter);
-			attribute.setter = std::move(setter);
-			m_attributes.emplace_back(attribute);
+			attribute.offset	= static_cast<unsigned int>(reinterpret_cast<const char*>(&value) - reinterpret_cast<const char*>(this));
+			attribute.size		= static_cast<unsigned int>(sizeof(T));
+			attribute.type_id	= typeid(T).hash_code();
+			attribute.set		= set;
+			if constexpr (!std::is_trivially_copyable<T>::value)
+			{
+				attribute.copy = [](void* destination, const void* source) { *static_cast<T*>(destination) = *static_cast<const T*>(source); };
+			}
+			RegisterAttribute(attribute);
 		}
+		void RegisterAttribute(const Attribute& attribute);
 
 		// The type of the component
 		ComponentType m_type		= ComponentType_Unknown;
@@ -150,7 +161,8 @@ namespace Directus
 		Context* m_context			= nullptr;
 
 	private:
-		// The attributes of the component
-		std::vector<Attribute> m_attributes;
+		// The attribute table of the component's type, and how many attributes this instance has registered
+		std::vector<Attribute>* m_attributes	= nullptr;
+		unsigned int m_attribute_count			= 0;
 	};
 }
\ No newline at end of file
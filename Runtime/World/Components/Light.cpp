@@ -46,7 +46,7 @@ namespace Directus
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_color, Vector4);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_bias, float);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_normalBias, float);
-		REGISTER_ATTRIBUTE_GET_SET(GetLightType, SetLightType, LightType);
+		REGISTER_ATTRIBUTE_VALUE_SET(m_lightType, SetLightType, LightType);
 
 		m_color = Vector4(1.0f, 0.76f, 0.57f, 1.0f);
 		m_renderer = m_context->GetSubsystem<Renderer>().get();
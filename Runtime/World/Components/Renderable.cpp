@@ -21,8 +21,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================================
 #include "Renderable.h"
+#include <map>
+#include <mutex>
+#include <tuple>
 #include "Transform.h"
 #include "../../IO/FileStream.h"
+#include "../World.h"
+#include "../Entity.h"
 #include "../../Resource/ResourceCache.h"
 #include "../../Rendering/Utilities/Geometry.h"
 #include "../../Rendering/Material.h"
@@ -36,92 +41,92 @@ using namespace Directus::Math;
 
 namespace Directus
 {
-	inline void build(const Geometry_Type type, Renderable* renderable)
-	{	
-		auto model = make_shared<Model>(renderable->GetContext());
-		vector<RHI_Vertex_PosUvNorTan> vertices;
-		vector<unsigned int> indices;
-
-		// Construct geometry
-		if (type == Geometry_Default_Cube)
-		{
-			Utility::Geometry::CreateCube(&vertices, &indices);		
-			model->SetResourceName("Default_Cube");
-		}
-		else if (type == Geometry_Default_Quad)
-		{
-			Utility::Geometry::CreateQuad(&vertices, &indices);
-			model->SetResourceName("Default_Cube");
-		}
-		else if (type == Geometry_Default_Sphere)
-		{
-			Utility::Geometry::CreateSphere(&vertices, &indices);
-			model->SetResourceName("Default_Cube");
-		}
-		else if (type == Geometry_Default_Cylinder)
-		{
-			Utility::Geometry::CreateCylinder(&vertices, &indices);
-			model->SetResourceName("Default_Cube");
-		}
-		else if (type == Geometry_Default_Cone)
+	namespace
+	{
+		const auto g_geometry_empty = make_shared<const RenderableGeometry>();
+
+		// Geometry which is still in use, so renderables drawing the same thing share it
+		map<tuple<Model*, unsigned int, unsigned int, unsigned int, unsigned int>, weak_ptr<const RenderableGeometry>> g_geometry_custom;
+		size_t g_geometry_custom_prune_size = 64; // the size at which expired entries are dropped next
+		map<Geometry_Type, weak_ptr<const RenderableGeometry>> g_geometry_default;
+		mutex g_geometry_mutex;
+
+		shared_ptr<const RenderableGeometry> build(const Geometry_Type type, Context* context)
 		{
-			Utility::Geometry::CreateCone(&vertices, &indices);
-			model->SetResourceName("Default_Cube");
-		}
+			auto model = make_shared<Model>(context);
+			vector<RHI_Vertex_PosUvNorTan> vertices;
+			vector<unsigned int> indices;
 
-		if (vertices.empty() || indices.empty())
-			return;
+			// Construct geometry
+			if (type == Geometry_Default_Cube)
+			{
+				Utility::Geometry::CreateCube(&vertices, &indices);		
+				model->SetResourceName("Default_Cube");
+			}
+			else if (type == Geometry_Default_Quad)
+			{
+				Utility::Geometry::CreateQuad(&vertices, &indices);
+				model->SetResourceName("Default_Cube");
+			}
+			else if (type == Geometry_Default_Sphere)
+			{
+				Utility::Geometry::CreateSphere(&vertices, &indices);
+				model->SetResourceName("Default_Cube");
+			}
+			else if (type == Geometry_Default_Cylinder)
+			{
+				Utility::Geometry::CreateCylinder(&vertices, &indices);
+				model->SetResourceName("Default_Cube");
+			}
+			else if (type == Geometry_Default_Cone)
+			{
+				Utility::Geometry::CreateCone(&vertices, &indices);
+				model->SetResourceName("Default_Cube");
+			}
+
+			if (vertices.empty() || indices.empty())
+				return nullptr;
+
+			model->GeometryAppend(indices, vertices, nullptr, nullptr);
+			model->GeometryUpdate();
 
-		model->GeometryAppend(indices, vertices, nullptr, nullptr);
-		model->GeometryUpdate();
-
-		renderable->GeometrySet(
-			"Default_Geometry",
-			0,
-			static_cast<unsigned int>(indices.size()),
-			0,
-			static_cast<unsigned int>(vertices.size()),
-			BoundingBox(vertices),
-			model
-		);
+			auto geometry			= make_shared<RenderableGeometry>();
+			geometry->name			= "Default_Geometry";
+			geometry->index_count	= static_cast<unsigned int>(indices.size());
+			geometry->vertex_count	= static_cast<unsigned int>(vertices.size());
+			geometry->aabb			= BoundingBox(vertices);
+			geometry->model			= model;
+			geometry->type			= type;
+
+			return geometry;
+		}
 	}
 
 	Renderable::Renderable(Context* context, Entity* entity, Transform* transform) : IComponent(context, entity, transform)
 	{
-		m_geometry_type			= Geometry_Custom;	
-		m_geometryIndexOffset	= 0;
-		m_geometryIndexCount	= 0;
-		m_geometryVertexOffset	= 0;
-		m_geometryVertexCount	= 0;
-		m_materialDefault		= false;
-		m_castShadows			= true;
-		m_receiveShadows		= true;
+		m_geometry			= g_geometry_empty;
+		m_materialDefault	= false;
+		m_castShadows		= true;
+		m_receiveShadows	= true;
 
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_materialDefault, bool);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_material, shared_ptr<Material>);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_castShadows, bool);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_receiveShadows, bool);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryIndexOffset, unsigned int);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryIndexCount, unsigned int);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryVertexOffset, unsigned int);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryVertexCount, unsigned int);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryName, string);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_model, shared_ptr<Model>);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryAABB, BoundingBox);
-		REGISTER_ATTRIBUTE_GET_SET(Geometry_Type, GeometrySet, Geometry_Type);
+		REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometry, shared_ptr<const RenderableGeometry>);
 	}
 
 	//= ICOMPONENT ===============================================================
 	void Renderable::Serialize(FileStream* stream)
 	{
 		// Mesh
-		stream->Write(static_cast<unsigned int>(m_geometry_type));
-		stream->Write(m_geometryIndexOffset);
-		stream->Write(m_geometryIndexCount);
-		stream->Write(m_geometryVertexOffset);
-		stream->Write(m_geometryVertexCount);
-		stream->Write(m_geometryAABB);
-		stream->Write(m_model ? m_model->GetResourceName() : NOT_ASSIGNED);
+		stream->Write(static_cast<unsigned int>(m_geometry->type));
+		stream->Write(m_geometry->index_offset);
+		stream->Write(m_geometry->index_count);
+		stream->Write(m_geometry->vertex_offset);
+		stream->Write(m_geometry->vertex_count);
+		stream->Write(m_geometry->aabb);
+		stream->Write(m_geometry->model ? m_geometry->model->GetResourceName() : NOT_ASSIGNED);
 
 		// Material
 		stream->Write(m_castShadows);
@@ -136,20 +141,25 @@ namespace Directus
 	void Renderable::Deserialize(FileStream* stream)
 	{
 		// Geometry
-		m_geometry_type			= static_cast<Geometry_Type>(stream->ReadAs<unsigned int>());
-		m_geometryIndexOffset	= stream->ReadAs<unsigned int>();
-		m_geometryIndexCount	= stream->ReadAs<unsigned int>();
-		m_geometryVertexOffset	= stream->ReadAs<unsigned int>();
-		m_geometryVertexCount	= stream->ReadAs<unsigned int>();
-		stream->Read(&m_geometryAABB);
+		const auto type				= static_cast<Geometry_Type>(stream->ReadAs<unsigned int>());
+		const auto index_offset		= stream->ReadAs<unsigned int>();
+		const auto index_count		= stream->ReadAs<unsigned int>();
+		const auto vertex_offset	= stream->ReadAs<unsigned int>();
+		const auto vertex_count		= stream->ReadAs<unsigned int>();
+		BoundingBox aabb;
+		stream->Read(&aabb);
 		string model_name;
 		stream->Read(&model_name);
-		m_model = m_context->GetSubsystem<ResourceCache>()->GetByName<Model>(model_name);
 
 		// If it was a default mesh, we have to reconstruct it
-		if (m_geometry_type != Geometry_Custom) 
+		if (type != Geometry_Custom) 
 		{
-			GeometrySet(m_geometry_type);
+			GeometrySet(type);
+		}
+		else
+		{
+			auto model = m_context->GetSubsystem<ResourceCache>()->GetByName<Model>(model_name);
+			GeometrySet(string(), index_offset, index_count, vertex_offset, vertex_count, aabb, model);
 		}
 
 		// Material
@@ -166,65 +176,131 @@ namespace Directus
 			stream->Read(&material_name);
 			m_material = m_context->GetSubsystem<ResourceCache>()->GetByName<Material>(material_name);
 		}
+
+		m_entity->TagsUpdate();
 	}
 	//==============================================================================
 
 	//= GEOMETRY =====================================================================================
 	void Renderable::GeometrySet(const string& name, const unsigned int index_offset, const unsigned int index_count, const unsigned int vertex_offset, const unsigned int vertex_count, const BoundingBox& aabb, shared_ptr<Model>& model)
-	{	
-		m_geometryName			= name;
-		m_geometryIndexOffset	= index_offset;
-		m_geometryIndexCount	= index_count;
-		m_geometryVertexOffset	= vertex_offset;
-		m_geometryVertexCount	= vertex_count;
-		m_geometryAABB			= aabb;
-		m_model					= model;
+	{
+		{
+			lock_guard<mutex> lock(g_geometry_mutex);
+
+			// Drop the entries of geometry that nobody draws anymore, once the map has doubled since the last time
+			if (g_geometry_custom.size() >= g_geometry_custom_prune_size)
+			{
+				for (auto it = g_geometry_custom.begin(); it != g_geometry_custom.end();)
+				{
+					it = it->second.expired() ? g_geometry_custom.erase(it) : next(it);
+				}
+				g_geometry_custom_prune_size = max<size_t>(64, g_geometry_custom.size() * 2);
+			}
+
+			// Share the geometry if another renderable draws the same part of the model
+			auto& cached = g_geometry_custom[make_tuple(model.get(), index_offset, index_count, vertex_offset, vertex_count)];
+			auto geometry = cached.lock();
+			if (!geometry || geometry->model != model)
+			{
+				auto geometry_new			= make_shared<RenderableGeometry>();
+				geometry_new->name			= name;
+				geometry_new->index_offset	= index_offset;
+				geometry_new->index_count	= index_count;
+				geometry_new->vertex_offset	= vertex_offset;
+				geometry_new->vertex_count	= vertex_count;
+				geometry_new->aabb			= aabb;
+				geometry_new->model			= model;
+				geometry					= geometry_new;
+				cached						= geometry;
+			}
+			m_geometry = geometry;
+		}
+
+		// The bounds have changed
+		m_context->GetSubsystem<World>()->SpatialUpdate(m_entity);
 	}
 
 	void Renderable::GeometrySet(const Geometry_Type type)
 	{
-		m_geometry_type = type;
+		if (type == Geometry_Custom)
+		{
+			// Keep drawing the same thing, it's just not considered default geometry anymore
+			if (m_geometry->type != Geometry_Custom)
+			{
+				auto geometry	= make_shared<RenderableGeometry>(*m_geometry);
+				geometry->type	= Geometry_Custom;
+				m_geometry		= geometry;
+			}
+			return;
+		}
 
-		if (type != Geometry_Custom)
 		{
-			build(type, this);
+			// Default geometry is built once and shared by everyone using it
+			lock_guard<mutex> lock(g_geometry_mutex);
+			auto& cached	= g_geometry_default[type];
+			auto geometry	= cached.lock();
+			if (!geometry)
+			{
+				geometry	= build(type, m_context);
+				cached		= geometry;
+			}
+
+			if (!geometry)
+				return;
+
+			m_geometry = geometry;
 		}
+
+		// The bounds have changed
+		m_context->GetSubsystem<World>()->SpatialUpdate(m_entity);
+	}
+
+	void Renderable::GeometryShare(const shared_ptr<const RenderableGeometry>& geometry)
+	{
+		m_geometry = geometry ? geometry : g_geometry_empty;
+
+		// The bounds have changed
+		m_context->GetSubsystem<World>()->SpatialUpdate(m_entity);
 	}
 
 	void Renderable::GeometryGet(vector<unsigned int>* indices, vector<RHI_Vertex_PosUvNorTan>* vertices) const
 	{
-		if (!m_model)
+		if (!m_geometry->model)
 		{
 			LOG_ERROR("Invalid model");
 			return;
 		}
 
-		m_model->GeometryGet(m_geometryIndexOffset, m_geometryIndexCount, m_geometryVertexOffset, m_geometryVertexCount, indices, vertices);
+		m_geometry->model->GeometryGet(m_geometry->index_offset, m_geometry->index_count, m_geometry->vertex_offset, m_geometry->vertex_count, indices, vertices);
 	}
 
 	BoundingBox Renderable::GeometryAabb()
 	{
-		return m_geometryAABB.Transformed(GetTransform()->GetMatrix());
+		return m_geometry->aabb.Transformed(GetTransform()->GetMatrix());
 	}
 	//==============================================================================
 
 	//= MATERIAL ===================================================================
 	// All functions (set/load) resolve to this
-	void Renderable::MaterialSet(const shared_ptr<Material>& material)
+	void Renderable::MaterialSet(const shared_ptr<Material>& material, const bool is_default)
 	{
 		if (!material)
 		{
 			LOG_ERROR_INVALID_PARAMETER();
 			return;
 		}
-		m_material = material;
+		m_material			= material;
+		m_materialDefault	= is_default;
+
+		// Let the renderer re-sort this entity
+		m_context->GetSubsystem<World>()->EntityResolve(GetEntity_PtrShared());
 	}
 
 	shared_ptr<Material> Renderable::MaterialSet(const string& file_path)
 	{
-		// Load the material
-		auto material = make_shared<Material>(GetContext());
-		if (!material->LoadFromFile(file_path))
+		// Load the material, it's drawn with a placeholder until it's done
+		auto material = GetContext()->GetSubsystem<ResourceCache>()->LoadAsync<Material>(file_path);
+		if (!material)
 		{
 			LOGF_WARNING("Failed to load material from \"%s\"", file_path.c_str());
 			return nullptr;
@@ -239,8 +315,6 @@ namespace Directus
 
 	void Renderable::MaterialUseDefault()
 	{
-		m_materialDefault = true;
-
 		auto data_dir = GetContext()->GetSubsystem<ResourceCache>()->GetDataDirectory();
 		FileSystem::CreateDirectory_(data_dir);
 		auto materialStandard = make_shared<Material>(GetContext());
@@ -248,7 +322,7 @@ namespace Directus
 		materialStandard->SetCullMode(Cull_Back);
 		materialStandard->SetColorAlbedo(Vector4(0.6f, 0.6f, 0.6f, 1.0f));
 		materialStandard->SetIsEditable(false);		
-		MaterialSet(materialStandard);
+		MaterialSet(materialStandard, true);
 	}
 
 	const string& Renderable::MaterialName()
@@ -256,4 +330,13 @@ namespace Directus
 		return m_material ? m_material->GetResourceName() : NOT_ASSIGNED;
 	}
 	//==============================================================================
+
+	void Renderable::SetCastShadows(const bool cast_shadows)
+	{
+		if (m_castShadows == cast_shadows)
+			return;
+
+		m_castShadows = cast_shadows;
+		m_entity->TagsUpdate();
+	}
 }
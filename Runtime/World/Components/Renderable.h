@@ -48,6 +48,20 @@ namespace Directus
 		Geometry_Default_Cone
 	};
 
+	// Which part of a model a renderable draws. It never changes once created (setting new geometry
+	// creates a new one), so renderables drawing the same part of the same model share it.
+	struct RenderableGeometry
+	{
+		std::string name;
+		unsigned int index_offset	= 0;
+		unsigned int index_count	= 0;
+		unsigned int vertex_offset	= 0;
+		unsigned int vertex_count	= 0;
+		Math::BoundingBox aabb;
+		std::shared_ptr<Model> model;
+		Geometry_Type type			= Geometry_Custom;
+	};
+
 	class ENGINE_CLASS Renderable : public IComponent
 	{
 	public:
@@ -71,20 +85,22 @@ namespace Directus
 		);
 		void GeometryGet(std::vector<unsigned int>* indices, std::vector<RHI_Vertex_PosUvNorTan>* vertices) const;
 		void GeometrySet(Geometry_Type type);
-		unsigned int GeometryIndexOffset() const		{ return m_geometryIndexOffset; }
-		unsigned int GeometryIndexCount() const			{ return m_geometryIndexCount; }		
-		unsigned int GeometryVertexOffset() const		{ return m_geometryVertexOffset; }
-		unsigned int GeometryVertexCount() const		{ return m_geometryVertexCount; }
-		Geometry_Type GeometryType() const				{ return m_geometry_type; }
-		const std::string& GeometryName() const			{ return m_geometryName; }
-		std::shared_ptr<Model> GeometryModel() const	{ return m_model; }
-		const Math::BoundingBox& GeometryAabb() const	{ return m_geometryAABB; }
+		void GeometryShare(const std::shared_ptr<const RenderableGeometry>& geometry);
+		const auto& GeometryShared() const				{ return m_geometry; }
+		unsigned int GeometryIndexOffset() const		{ return m_geometry->index_offset; }
+		unsigned int GeometryIndexCount() const			{ return m_geometry->index_count; }		
+		unsigned int GeometryVertexOffset() const		{ return m_geometry->vertex_offset; }
+		unsigned int GeometryVertexCount() const		{ return m_geometry->vertex_count; }
+		Geometry_Type GeometryType() const				{ return m_geometry->type; }
+		const std::string& GeometryName() const			{ return m_geometry->name; }
+		std::shared_ptr<Model> GeometryModel() const	{ return m_geometry->model; }
+		const Math::BoundingBox& GeometryAabb() const	{ return m_geometry->aabb; }
 		Math::BoundingBox GeometryAabb();
 		//========================================================================================================
 
 		//= MATERIAL ============================================================
-		// Sets a material from memory (adds it to the resource cache by default)
-		void MaterialSet(const std::shared_ptr<Material>& material);
+		// Sets a material from memory
+		void MaterialSet(const std::shared_ptr<Material>& material, bool is_default = false);
 
 		// Loads a material and the sets it
 		std::shared_ptr<Material> MaterialSet(const std::string& file_path);
@@ -93,26 +109,20 @@ namespace Directus
 		const std::string& MaterialName();
 		auto MaterialPtr() const	{ return m_material; }
 		bool MaterialExists() const { return m_material != nullptr; }
+		bool MaterialIsDefault() const	{ return m_materialDefault; }
 		//=======================================================================
 
 		//= PROPERTIES ============================================================================
-		void SetCastShadows(const bool cast_shadows)		{ m_castShadows = cast_shadows; }
+		void SetCastShadows(bool cast_shadows);
 		bool GetCastShadows() const							{ return m_castShadows; }
 		void SetReceiveShadows(const bool receive_shadows)	{ m_receiveShadows = receive_shadows; }
 		bool GetReceiveShadows() const						{ return m_receiveShadows; }
 		//=========================================================================================
 
 	private:
-		//= GEOMETRY =======================
-		std::string m_geometryName;
-		unsigned int m_geometryIndexOffset;
-		unsigned int m_geometryIndexCount;
-		unsigned int m_geometryVertexOffset;
-		unsigned int m_geometryVertexCount;
-		Math::BoundingBox m_geometryAABB;
-		std::shared_ptr<Model> m_model;
-		Geometry_Type m_geometry_type;
-		//==================================
+		//= GEOMETRY =================================================
+		std::shared_ptr<const RenderableGeometry> m_geometry; // never null
+		//============================================================
 
 		//= MATERIAL ========================
 		std::shared_ptr<Material> m_material;
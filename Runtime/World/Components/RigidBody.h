@@ -55,6 +55,7 @@ namespace Directus
 		void OnRemove() override;
 		void OnStart() override;
 		void OnTick() override;
+		bool IsTickParallel() const override { return true; }
 		void Serialize(FileStream* stream) override;
 		void Deserialize(FileStream* stream) override;
 		//============================================
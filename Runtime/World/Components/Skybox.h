@@ -46,6 +46,7 @@ namespace Directus
 		//= IComponent ==============
 		void OnInitialize() override;
 		void OnTick() override;
+		bool IsTickParallel() const override { return true; }
 		//===========================
 
 		const std::shared_ptr<RHI_Texture>& GetTexture()	{ return m_cubemapTexture; }
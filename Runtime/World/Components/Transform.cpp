@@ -21,6 +21,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ============================
 #include "Transform.h"
+#include <algorithm>
 #include "../World.h"
 #include "../Entity.h"
 #include "../../IO/FileStream.h"
@@ -40,15 +41,19 @@ namespace Directus
 		m_positionLocal		= Vector3::Zero;
 		m_rotationLocal		= Quaternion(0, 0, 0, 1);
 		m_scaleLocal		= Vector3::One;
+		m_position			= Vector3::Zero;
+		m_rotation			= Quaternion(0, 0, 0, 1);
+		m_scale				= Vector3::One;
 		m_matrix			= Matrix::Identity;
 		m_matrixLocal		= Matrix::Identity;
 		m_wvp_previous		= Matrix::Identity;
 		m_parent			= nullptr;
+		m_world				= context->GetSubsystem<World>().get();
 
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_positionLocal,	Vector3);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotationLocal,	Quaternion);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_scaleLocal, Vector3);
-		REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrix, Matrix);
+		REGISTER_ATTRIBUTE_VALUE_SET(m_matrix, SetMatrix, Matrix);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrixLocal, Matrix);
 		REGISTER_ATTRIBUTE_VALUE_VALUE(m_lookAt, Vector3);
 	}
@@ -94,14 +99,7 @@ namespace Directus
 		m_matrixLocal = Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal);
 
 		// Compute world transform
-		if (!HasParent())
-		{
-			m_matrix = m_matrixLocal;
-		}
-		else
-		{
-			m_matrix = m_matrixLocal * GetParentTransformMatrix();
-		}
+		SetMatrix(!HasParent() ? m_matrixLocal : m_matrixLocal * GetParentTransformMatrix());
 		
 		// Update children
 		for (const auto& child : m_children)
@@ -265,12 +263,18 @@ namespace Directus
 		// Switch parent but keep a pointer to the old one
 		auto parent_old = m_parent;
 		m_parent = new_parent;
-		if (parent_old) parent_old->AcquireChildren(); // update the old parent (so it removes this child)
+
+		// update the old parent (so it removes this child) without searching the whole world
+		if (parent_old)
+		{
+			auto& siblings = parent_old->m_children;
+			siblings.erase(remove(siblings.begin(), siblings.end(), this), siblings.end());
+		}
 
 		// make the new parent "aware" of this transform/child
-		if (m_parent)
+		if (m_parent && find(m_parent->m_children.begin(), m_parent->m_children.end(), this) == m_parent->m_children.end())
 		{
-			m_parent->AcquireChildren();
+			m_parent->m_children.emplace_back(this);
 		}
 
 		UpdateTransform();
@@ -427,6 +431,20 @@ namespace Directus
 		cb_light.buffer->Unmap();
 	}
 
+	void Transform::SetMatrix(const Matrix& matrix)
+	{
+		m_matrix = matrix;
+
+		// Decompose here, so the getters don't have to do it every time they are called
+		m_matrix.Decompose(m_scale, m_rotation, m_position);
+
+		// The bounds of the renderable have moved
+		if (m_world && m_entity->GetRenderable_PtrRaw())
+		{
+			m_world->SpatialUpdate(m_entity);
+		}
+	}
+
 	Matrix Transform::GetParentTransformMatrix() const
 	{
 		return HasParent() ? GetParent()->GetMatrix() : Matrix::Identity;
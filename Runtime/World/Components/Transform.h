@@ -33,6 +33,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace Directus
 {
 	class RHI_Device;
+	class World;
 	class RHI_ConstantBuffer;
 
 	class ENGINE_CLASS Transform : public IComponent
@@ -50,21 +51,21 @@ namespace Directus
 		void UpdateTransform();
 
 		//= POSITION ========================================================================
-		Math::Vector3 GetPosition()						{ return m_matrix.GetTranslation(); }
+		const Math::Vector3& GetPosition() const		{ return m_position; }
 		const Math::Vector3& GetPositionLocal() const	{ return m_positionLocal; }
 		void SetPosition(const Math::Vector3& position);
 		void SetPositionLocal(const Math::Vector3& position);
 		//===================================================================================
 
 		//= ROTATION =========================================================================
-		Math::Quaternion GetRotation()						{ return m_matrix.GetRotation(); }
+		const Math::Quaternion& GetRotation() const			{ return m_rotation; }
 		const Math::Quaternion& GetRotationLocal() const	{ return m_rotationLocal; }
 		void SetRotation(const Math::Quaternion& rotation);
 		void SetRotationLocal(const Math::Quaternion& rotation);
 		//====================================================================================
 
 		//= SCALE =================================================================
-		Math::Vector3 GetScale()					{ return m_matrix.GetScale(); }
+		const Math::Vector3& GetScale() const		{ return m_scale; }
 		const Math::Vector3& GetScaleLocal() const	{ return m_scaleLocal; }
 		void SetScale(const Math::Vector3& scale);
 		void SetScaleLocal(const Math::Vector3& scale);
@@ -113,6 +114,12 @@ namespace Directus
 
 	private:
 		Math::Matrix GetParentTransformMatrix() const;
+		void SetMatrix(const Math::Matrix& matrix);
+
+		// world (decomposed once per matrix update)
+		Math::Vector3 m_position;
+		Math::Quaternion m_rotation;
+		Math::Vector3 m_scale;
 
 		// local
 		Math::Vector3 m_positionLocal;
@@ -125,6 +132,7 @@ namespace Directus
 
 		Transform* m_parent; // the parent of this transform
 		std::vector<Transform*> m_children; // the children of this transform
+		World* m_world; // keeps the spatial index up to date
 
 		// Constant buffer
 		struct CB_Gbuffer
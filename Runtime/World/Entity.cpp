@@ -90,15 +90,20 @@ namespace Directus
 			clone->SetName(entity->GetName());
 			clone->SetActive(entity->IsActive());
 			clone->SetHierarchyVisibility(entity->IsVisibleInHierarchy());
+			clone->m_tags	= entity->m_tags & ~Tag_Engine;
+			clone->m_layers	= entity->m_layers;
 
 			// Clone all the components
 			for (const auto& component : entity->GetAllComponents())
 			{
 				const auto& original_comp	= component;
 				auto clone_comp				= clone->AddComponent(component->GetType());
-				clone_comp->SetAttributes(original_comp->GetAttributes());
+				clone_comp->CopyAttributes(original_comp.get());
 			}
 
+			// The attributes (e.g. material) were copied after the components were added, so resolve again
+			clone->Resolve();
+
 			clones.emplace_back(clone);
 
 			return clone;
@@ -121,7 +126,8 @@ namespace Directus
 			return clone_self;
 		};
 
-		// Clone the entire hierarchy
+		// Clone the entire hierarchy (announcing all the clones at once)
+		World::BatchScope batch(scene.get());
 		clone_entity_and_descendants(this);
 	}
 
@@ -155,6 +161,21 @@ namespace Directus
 		}
 	}
 
+	void Entity::Tick(const bool parallel)
+	{
+		if (!m_is_active)
+			return;
+
+		// call Update() only for the components which match the requested tick phase
+		for (const auto& component : m_components)
+		{
+			if (component->IsTickParallel() == parallel)
+			{
+				component->OnTick();
+			}
+		}
+	}
+
 	void Entity::Serialize(FileStream* stream)
 	{
 		//= BASIC DATA ======================
@@ -270,7 +291,7 @@ namespace Directus
 		}
 
 		// Make the scene resolve
-		FIRE_EVENT(Event_World_Resolve);
+		Resolve();
 	}
 
 	shared_ptr<IComponent> Entity::AddComponent(const ComponentType type)
@@ -295,12 +316,59 @@ namespace Directus
 			default:																		break;
 		}
 
-		// Make the scene resolve
-		FIRE_EVENT(Event_World_Resolve);
-
 		return component;
 	}
 
+	void Entity::SetTag(const Entity_Tag tag, const bool enabled)
+	{
+		if (tag & Tag_Engine)
+		{
+			LOG_WARNING("Engine tags are derived from the components and can't be set.");
+			return;
+		}
+
+		const auto tags = enabled ? (m_tags | tag) : (m_tags & ~tag);
+		if (tags == m_tags)
+			return;
+
+		m_tags = tags;
+		m_context->GetSubsystem<World>()->EntitiesMasksDirty();
+	}
+
+	void Entity::TagsUpdate()
+	{
+		uint32_t tags = m_tags & ~Tag_Engine;
+		if (m_renderable)
+		{
+			tags |= Tag_Renderable;
+			tags |= m_renderable->GetCastShadows() ? Tag_ShadowCaster : Tag_None;
+		}
+		tags |= HasComponent<Light>()	? Tag_Light		: Tag_None;
+		tags |= HasComponent<Camera>()	? Tag_Camera	: Tag_None;
+		tags |= HasComponent<Skybox>()	? Tag_Skybox	: Tag_None;
+
+		if (tags == m_tags)
+			return;
+
+		m_tags = tags;
+		m_context->GetSubsystem<World>()->EntitiesMasksDirty();
+	}
+
+	void Entity::SetLayers(const uint32_t layers)
+	{
+		if (layers == m_layers)
+			return;
+
+		m_layers = layers;
+		m_context->GetSubsystem<World>()->EntitiesMasksDirty();
+	}
+
+	void Entity::Resolve()
+	{
+		TagsUpdate();
+		m_context->GetSubsystem<World>()->EntityResolve(GetPtrShared());
+	}
+
 	void Entity::RemoveComponentById(const unsigned int id)
 	{
 		for (auto it = m_components.begin(); it != m_components.end(); ) 
@@ -308,8 +376,12 @@ namespace Directus
 			auto component = *it;
 			if (id == component->GetID())
 			{
+				if (component->GetType() == ComponentType_Renderable)
+				{
+					m_renderable = nullptr;
+				}
 				component->OnRemove();
-				component.reset();
+				ComponentRetire(component);
 				it = m_components.erase(it);
 			}
 			else
@@ -319,6 +391,12 @@ namespace Directus
 		}
 
 		// Make the scene resolve
-		FIRE_EVENT(Event_World_Resolve);
+		Resolve();
+	}
+
+	void Entity::ComponentRetire(const shared_ptr<IComponent>& component) const
+	{
+		// The renderer might still be using it this frame
+		m_context->GetSubsystem<World>()->Retire(component);
 	}
 }
@@ -34,6 +34,26 @@ namespace Directus
 	class Renderable;
 	#define VALIDATE_COMPONENT_TYPE(T) static_assert(std::is_base_of<IComponent, T>::value, "Provided type does not implement IComponent")
 
+	// The low 16 bits are derived from the components (by the engine), the high 16 bits are set by the user
+	enum Entity_Tag : uint32_t
+	{
+		Tag_None			= 0,
+		// Engine
+		Tag_Renderable		= 1 << 0,
+		Tag_ShadowCaster	= 1 << 1,
+		Tag_Light			= 1 << 2,
+		Tag_Camera			= 1 << 3,
+		Tag_Skybox			= 1 << 4,
+		Tag_Engine			= 0x0000FFFF,
+		// User
+		Tag_Pickable		= 1 << 16,
+		Tag_EditorOnly		= 1 << 17,
+		Tag_User			= 1 << 18	// first unused user tag
+	};
+
+	static const uint32_t Layer_Default	= 1 << 0;
+	static const uint32_t Layer_All		= 0xFFFFFFFF;
+
 	class ENGINE_CLASS Entity : public std::enable_shared_from_this<Entity>
 	{
 	public:
@@ -47,6 +67,7 @@ namespace Directus
 		void Start();
 		void Stop();
 		void Tick();
+		void Tick(bool parallel);
 		//===========
 
 		void Serialize(FileStream* stream);
@@ -66,6 +87,19 @@ namespace Directus
 		void SetHierarchyVisibility(const bool hierarchy_visibility)	{ m_hierarchy_visibility = hierarchy_visibility; }
 		//================================================================================================================
 
+		//= TAGS & LAYERS ==============================================================
+		uint32_t GetTags() const					{ return m_tags; }
+		bool HasTags(const uint32_t tags) const		{ return (m_tags & tags) == tags; }
+		// Only user tags can be set, engine tags follow the components
+		void SetTag(Entity_Tag tag, bool enabled = true);
+		// Re-derives the engine tags, components call it when a property that affects them changes
+		void TagsUpdate();
+
+		uint32_t GetLayers() const					{ return m_layers; }
+		bool IsInLayers(const uint32_t layers) const	{ return (m_layers & layers) != 0; }
+		void SetLayers(uint32_t layers);
+		//==============================================================================
+
 		// Adds a component of ComponentType 
 		std::shared_ptr<IComponent> AddComponent(ComponentType type);
 
@@ -102,7 +136,7 @@ namespace Directus
 			}
 
 			// Make the scene resolve
-			FIRE_EVENT(Event_World_Resolve);
+			Resolve();
 
 			return new_component;
 		}
@@ -174,8 +208,12 @@ namespace Directus
 				auto component = *it;
 				if (component->GetType() == type)
 				{
+					if (type == ComponentType_Renderable)
+					{
+						m_renderable = nullptr;
+					}
 					component->OnRemove();
-					component.reset();
+					ComponentRetire(component);
 					it = m_components.erase(it);
 				}
 				else
@@ -185,7 +223,7 @@ namespace Directus
 			}
 
 			// Make the scene resolve
-			FIRE_EVENT(Event_World_Resolve);
+			Resolve();
 		}
 
 		void RemoveComponentById(unsigned int id);
@@ -197,10 +235,17 @@ namespace Directus
 		std::shared_ptr<Entity> GetPtrShared()		{ return shared_from_this(); }
 
 	private:
+		// Lets the world (and the renderer) know that the components have changed
+		void Resolve();
+		// Hands a removed component to the world, which frees it once no frame can be using it
+		void ComponentRetire(const std::shared_ptr<IComponent>& component) const;
+
 		unsigned int m_id			= 0;
 		std::string m_name			= "Entity";
 		bool m_is_active			= true;
 		bool m_hierarchy_visibility	= true;
+		uint32_t m_tags				= Tag_Pickable;
+		uint32_t m_layers			= Layer_Default;
 		// Caching of performance critical components
 		Transform* m_transform		= nullptr;
 		Renderable* m_renderable	= nullptr;
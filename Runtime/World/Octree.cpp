@@ -0,0 +1,269 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==================
+#include "Octree.h"
+#include <algorithm>
+#include "../Math/Frustum.h"
+#include "../Math/Ray.h"
+//=============================
+
+//= NAMESPACES ========================
+using namespace std;
+using namespace Directus::Math;
+using namespace Directus::Math::Helper;
+//=====================================
+
+namespace Directus
+{
+	Octree::Octree(const float extent, const unsigned int depth_max)
+	{
+		m_extent	= extent;
+		m_depth_max	= depth_max;
+		Clear();
+	}
+
+	void Octree::Insert(Entity* entity, const BoundingBox& box)
+	{
+		if (!entity)
+			return;
+
+		// Nothing to place
+		if (!box.Defined())
+		{
+			Remove(entity);
+			return;
+		}
+
+		auto node = GetNode(box);
+
+		// Already in the tree, if it still belongs to the same node just update the box
+		auto it = m_items.find(entity);
+		if (it != m_items.end())
+		{
+			if (it->second.node == node)
+			{
+				node->entries[it->second.index].box = box;
+				return;
+			}
+
+			// Removing prunes empty branches, which can include the node just found, so it's looked up again
+			Remove(entity);
+			node = GetNode(box);
+		}
+
+		m_items[entity] = { node, static_cast<unsigned int>(node->entries.size()) };
+		node->entries.push_back({ entity, box });
+		for (auto n = node; n; n = n->parent)
+		{
+			n->count++;
+		}
+	}
+
+	void Octree::Remove(Entity* entity)
+	{
+		// The entity might be gone already, so it's only used as a key
+		auto it = m_items.find(entity);
+		if (it == m_items.end())
+			return;
+
+		auto node			= it->second.node;
+		const auto index	= it->second.index;
+		m_items.erase(it);
+
+		// Swap with the last entry and pop
+		if (index != node->entries.size() - 1)
+		{
+			node->entries[index] = node->entries.back();
+			m_items[node->entries[index].entity].index = index;
+		}
+		node->entries.pop_back();
+
+		for (auto n = node; n; n = n->parent)
+		{
+			n->count--;
+		}
+
+		Prune(node);
+	}
+
+	void Octree::Clear()
+	{
+		m_items.clear();
+		m_root					= make_unique<Node>();
+		m_root->center			= Vector3::Zero;
+		m_root->extent			= m_extent;
+		m_root->bounds_loose	= BoundingBox(Vector3(-m_extent * 2.0f), Vector3(m_extent * 2.0f));
+	}
+
+	void Octree::QueryFrustum(const Frustum& frustum, vector<Entity*>* entities) const
+	{
+		Query(m_root.get(), [&frustum](const BoundingBox& box) { return frustum.CheckCube(box.GetCenter(), box.GetExtents()); }, false, entities);
+	}
+
+	void Octree::QueryAABB(const BoundingBox& box, vector<Entity*>* entities) const
+	{
+		Query(m_root.get(), [&box](const BoundingBox& other) { return box.IsInside(other); }, false, entities);
+	}
+
+	void Octree::QuerySphere(const Vector3& center, const float radius, vector<Entity*>* entities) const
+	{
+		const auto radius_squared = radius * radius;
+		Query(m_root.get(), [&center, radius_squared](const BoundingBox& box)
+		{
+			// Closest point of the box to the center
+			const auto& min			= box.GetMin();
+			const auto& max			= box.GetMax();
+			const auto closest		= Vector3(Clamp(center.x, min.x, max.x), Clamp(center.y, min.y, max.y), Clamp(center.z, min.z, max.z));
+			if ((closest - center).LengthSquared() > radius_squared)
+				return Outside;
+
+			// Farthest corner of the box from the center
+			const auto farthest = Vector3
+			(
+				Max(Abs(center.x - min.x), Abs(center.x - max.x)),
+				Max(Abs(center.y - min.y), Abs(center.y - max.y)),
+				Max(Abs(center.z - min.z), Abs(center.z - max.z))
+			);
+			return farthest.LengthSquared() <= radius_squared ? Inside : Intersects;
+		}, false, entities);
+	}
+
+	void Octree::Raycast(const Ray& ray, vector<pair<Entity*, float>>* hits) const
+	{
+		Raycast(m_root.get(), ray, hits);
+	}
+
+	Octree::Node* Octree::GetNode(const BoundingBox& box)
+	{
+		auto node = m_root.get();
+
+		// Entities centered outside of the root's cell stay in the root
+		const auto center = box.GetCenter();
+		if (Abs(center.x) > m_extent || Abs(center.y) > m_extent || Abs(center.z) > m_extent)
+			return node;
+
+		// Descend for as long as the entity fits in the loose bounds of the child
+		const auto size			= box.GetSize();
+		const auto half_size	= Max(size.x, Max(size.y, size.z)) * 0.5f;
+		for (unsigned int depth = 0; depth < m_depth_max; depth++)
+		{
+			const auto child_extent = node->extent * 0.5f;
+			if (half_size > child_extent)
+				break;
+
+			const unsigned int index =
+				(center.x >= node->center.x ? 1 : 0) |
+				(center.y >= node->center.y ? 2 : 0) |
+				(center.z >= node->center.z ? 4 : 0);
+
+			auto& child = node->children[index];
+			if (!child)
+			{
+				child				= make_unique<Node>();
+				child->parent		= node;
+				child->extent		= child_extent;
+				child->center		= node->center + Vector3
+				(
+					(index & 1) ? child_extent : -child_extent,
+					(index & 2) ? child_extent : -child_extent,
+					(index & 4) ? child_extent : -child_extent
+				);
+				child->bounds_loose	= BoundingBox(child->center - Vector3(child_extent * 2.0f), child->center + Vector3(child_extent * 2.0f));
+			}
+			node = child.get();
+		}
+
+		return node;
+	}
+
+	void Octree::Prune(Node* node)
+	{
+		// Release empty branches, bottom up
+		while (node && node != m_root.get() && node->count == 0)
+		{
+			auto parent = node->parent;
+			for (auto& child : parent->children)
+			{
+				if (child.get() == node)
+				{
+					child.reset();
+					break;
+				}
+			}
+			node = parent;
+		}
+	}
+
+	template <typename Test>
+	void Octree::Query(const Node* node, const Test& test, bool inside, vector<Entity*>* entities) const
+	{
+		if (!node || node->count == 0)
+			return;
+
+		// The root also holds anything outside of its bounds, so it's never rejected
+		if (!inside && node != m_root.get())
+		{
+			const auto result = test(node->bounds_loose);
+			if (result == Outside)
+				return;
+
+			// Everything below is inside too, no need to test it
+			inside = result == Inside;
+		}
+
+		for (const auto& entry : node->entries)
+		{
+			if (inside || test(entry.box) != Outside)
+			{
+				entities->emplace_back(entry.entity);
+			}
+		}
+
+		for (const auto& child : node->children)
+		{
+			Query(child.get(), test, inside, entities);
+		}
+	}
+
+	void Octree::Raycast(const Node* node, const Ray& ray, vector<pair<Entity*, float>>* hits) const
+	{
+		if (!node || node->count == 0)
+			return;
+
+		if (node != m_root.get() && ray.HitDistance(node->bounds_loose) == INFINITY)
+			return;
+
+		for (const auto& entry : node->entries)
+		{
+			const auto distance = ray.HitDistance(entry.box);
+			if (distance != INFINITY)
+			{
+				hits->emplace_back(entry.entity, distance);
+			}
+		}
+
+		for (const auto& child : node->children)
+		{
+			Raycast(child.get(), ray, hits);
+		}
+	}
+}
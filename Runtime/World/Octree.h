@@ -0,0 +1,100 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include "../Core/EngineDefs.h"
+#include "../Math/BoundingBox.h"
+//=============================
+
+namespace Directus
+{
+	class Entity;
+
+	namespace Math
+	{
+		class Frustum;
+		class Ray;
+	}
+
+	// A loose octree over world space bounding boxes. The bounds of every node are twice the size of its
+	// cell, so an entity is placed using only its size and center and never has to straddle nodes.
+	class ENGINE_CLASS Octree
+	{
+	public:
+		Octree(float extent = 4096.0f, unsigned int depth_max = 8);
+		~Octree() = default;
+
+		// Inserts an entity, or moves it if it's already in the tree
+		void Insert(Entity* entity, const Math::BoundingBox& box);
+		void Remove(Entity* entity);
+		void Clear();
+
+		//= QUERIES ===========================================================================================
+		void QueryFrustum(const Math::Frustum& frustum, std::vector<Entity*>* entities) const;
+		void QueryAABB(const Math::BoundingBox& box, std::vector<Entity*>* entities) const;
+		void QuerySphere(const Math::Vector3& center, float radius, std::vector<Entity*>* entities) const;
+		// Returns every entity whose bounding box is hit, along with the hit distance (unsorted)
+		void Raycast(const Math::Ray& ray, std::vector<std::pair<Entity*, float>>* hits) const;
+		//=====================================================================================================
+
+		unsigned int GetEntityCount() const { return static_cast<unsigned int>(m_items.size()); }
+
+	private:
+		struct Entry
+		{
+			Entity* entity;
+			Math::BoundingBox box;
+		};
+
+		struct Node
+		{
+			Math::Vector3 center;
+			float extent			= 0.0f; // half the size of the cell
+			Math::BoundingBox bounds_loose;
+			Node* parent			= nullptr;
+			std::unique_ptr<Node> children[8];
+			std::vector<Entry> entries;
+			unsigned int count		= 0; // entries in this node and all of its descendants
+		};
+
+		struct Item
+		{
+			Node* node;
+			unsigned int index;
+		};
+
+		Node* GetNode(const Math::BoundingBox& box);
+		void Prune(Node* node);
+		template <typename Test>
+		void Query(const Node* node, const Test& test, bool inside, std::vector<Entity*>* entities) const;
+		void Raycast(const Node* node, const Math::Ray& ray, std::vector<std::pair<Entity*, float>>* hits) const;
+
+		std::unique_ptr<Node> m_root;
+		std::unordered_map<Entity*, Item> m_items;
+		float m_extent;
+		unsigned int m_depth_max;
+	};
+}
@@ -0,0 +1,267 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =============================
+#include "Prefab.h"
+#include <algorithm>
+#include "World.h"
+#include "Entity.h"
+#include "Components/Transform.h"
+#include "Components/Renderable.h"
+#include "../IO/FileStream.h"
+#include "../Rendering/Model.h"
+#include "../Rendering/Material.h"
+#include "../Resource/ResourceCache.h"
+//========================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus::Math;
+//=============================
+
+namespace Directus
+{
+	Prefab::Prefab(Context* context) : IResource(context, Resource_Prefab)
+	{
+
+	}
+
+	//= RESOURCE INTERFACE ===========================================================================================
+	bool Prefab::LoadFromFile(const string& file_path)
+	{
+		auto file = make_unique<FileStream>(file_path, FileStreamMode_Read);
+		if (!file->IsOpen())
+			return false;
+
+		auto resource_cache = m_context->GetSubsystem<ResourceCache>();
+
+		m_nodes.clear();
+		m_nodes.resize(file->ReadAs<unsigned int>());
+		for (auto& node : m_nodes)
+		{
+			file->Read(&node.name);
+			file->Read(&node.parent);
+			file->Read(&node.position);
+			file->Read(&node.rotation);
+			file->Read(&node.scale);
+			file->Read(&node.has_renderable);
+			if (!node.has_renderable)
+				continue;
+
+			// Geometry, default geometry is rebuilt (and shared) by the renderable on instantiation
+			auto geometry			= make_shared<RenderableGeometry>();
+			geometry->type			= static_cast<Geometry_Type>(file->ReadAs<unsigned int>());
+			file->Read(&geometry->name);
+			file->Read(&geometry->index_offset);
+			file->Read(&geometry->index_count);
+			file->Read(&geometry->vertex_offset);
+			file->Read(&geometry->vertex_count);
+			file->Read(&geometry->aabb);
+			const auto model_path = file->ReadAs<string>();
+			if (geometry->type == Geometry_Custom && model_path != NOT_ASSIGNED)
+			{
+				geometry->model = resource_cache->Load<Model>(model_path);
+			}
+			node.geometry = geometry;
+
+			// Material
+			file->Read(&node.cast_shadows);
+			file->Read(&node.receive_shadows);
+			file->Read(&node.material_default);
+			const auto material_path = file->ReadAs<string>();
+			if (!node.material_default && material_path != NOT_ASSIGNED)
+			{
+				node.material = resource_cache->Load<Material>(material_path);
+			}
+		}
+
+		return true;
+	}
+
+	bool Prefab::SaveToFile(const string& file_path)
+	{
+		auto file = make_unique<FileStream>(file_path, FileStreamMode_Write);
+		if (!file->IsOpen())
+			return false;
+
+		file->Write(static_cast<unsigned int>(m_nodes.size()));
+		for (const auto& node : m_nodes)
+		{
+			file->Write(node.name);
+			file->Write(node.parent);
+			file->Write(node.position);
+			file->Write(node.rotation);
+			file->Write(node.scale);
+			file->Write(node.has_renderable);
+			if (!node.has_renderable)
+				continue;
+
+			const auto& geometry = node.geometry;
+			file->Write(static_cast<unsigned int>(geometry->type));
+			file->Write(geometry->name);
+			file->Write(geometry->index_offset);
+			file->Write(geometry->index_count);
+			file->Write(geometry->vertex_offset);
+			file->Write(geometry->vertex_count);
+			file->Write(geometry->aabb);
+			file->Write(geometry->model ? geometry->model->GetResourceFilePath() : NOT_ASSIGNED);
+
+			file->Write(node.cast_shadows);
+			file->Write(node.receive_shadows);
+			file->Write(node.material_default);
+			file->Write(node.material && !node.material_default ? node.material->GetResourceFilePath() : NOT_ASSIGNED);
+		}
+
+		return true;
+	}
+	//================================================================================================================
+
+	bool Prefab::CreateFromEntity(Entity* root)
+	{
+		if (!root)
+		{
+			LOG_ERROR_INVALID_PARAMETER();
+			return false;
+		}
+
+		m_nodes.clear();
+
+		// Flatten the hierarchy, breadth first, so parents always precede their children
+		vector<Transform*> transforms = { root->GetTransform_PtrRaw() };
+		for (unsigned int i = 0; i < transforms.size(); i++)
+		{
+			auto transform	= transforms[i];
+			auto entity		= transform->GetEntity_PtrRaw();
+
+			// The root is stored at the origin, instances are placed on instantiation
+			Node node;
+			node.name		= entity->GetName();
+			node.position	= i != 0 ? transform->GetPositionLocal() : Vector3::Zero;
+			node.rotation	= i != 0 ? transform->GetRotationLocal() : Quaternion::Identity;
+			node.scale		= transform->GetScaleLocal();
+			if (i != 0)
+			{
+				node.parent = static_cast<int>(find(transforms.begin(), transforms.begin() + i, transform->GetParent()) - transforms.begin());
+			}
+
+			if (auto renderable = entity->GetRenderable_PtrRaw())
+			{
+				node.has_renderable		= true;
+				node.geometry			= renderable->GeometryShared();
+				node.material			= renderable->MaterialPtr();
+				node.material_default	= renderable->MaterialIsDefault();
+				node.cast_shadows		= renderable->GetCastShadows();
+				node.receive_shadows	= renderable->GetReceiveShadows();
+			}
+
+			for (const auto& component : entity->GetAllComponents())
+			{
+				const auto type = component->GetType();
+				if (type != ComponentType_Transform && type != ComponentType_Renderable)
+				{
+					LOGF_WARNING("Entity \"%s\" has components that prefabs don't capture, they will be ignored.", node.name.c_str());
+					break;
+				}
+			}
+
+			m_nodes.emplace_back(node);
+			for (const auto& child : transform->GetChildren())
+			{
+				transforms.emplace_back(child);
+			}
+		}
+
+		return true;
+	}
+
+	shared_ptr<Entity> Prefab::Instantiate(const Vector3& position, const Quaternion& rotation) const
+	{
+		if (m_nodes.empty())
+		{
+			LOG_WARNING("Prefab is empty, nothing to instantiate.");
+			return nullptr;
+		}
+
+		auto world = m_context->GetSubsystem<World>();
+		World::BatchScope batch(world.get());
+
+		vector<shared_ptr<Entity>> entities;
+		entities.reserve(m_nodes.size());
+		for (const auto& node : m_nodes)
+		{
+			auto entity = world->EntityCreate();
+			entity->SetName(node.name);
+
+			auto transform = entity->GetTransform_PtrRaw();
+			if (node.parent != -1)
+			{
+				transform->SetParent(entities[node.parent]->GetTransform_PtrRaw());
+			}
+			transform->SetPositionLocal(node.position);
+			transform->SetRotationLocal(node.rotation);
+			transform->SetScaleLocal(node.scale);
+
+			if (node.has_renderable)
+			{
+				auto renderable = entity->AddComponent<Renderable>();
+
+				// Custom geometry is shared as is, default geometry is shared by the renderable itself
+				if (node.geometry->type == Geometry_Custom)
+				{
+					renderable->GeometryShare(node.geometry);
+				}
+				else
+				{
+					renderable->GeometrySet(node.geometry->type);
+				}
+
+				if (node.material_default)
+				{
+					// One default material for all the instances, rather than a new one each
+					if (m_material_default)
+					{
+						renderable->MaterialSet(m_material_default, true);
+					}
+					else
+					{
+						renderable->MaterialUseDefault();
+						m_material_default = renderable->MaterialPtr();
+					}
+				}
+				else if (node.material)
+				{
+					renderable->MaterialSet(node.material);
+				}
+				renderable->SetCastShadows(node.cast_shadows);
+				renderable->SetReceiveShadows(node.receive_shadows);
+			}
+
+			entities.emplace_back(entity);
+		}
+
+		// Place the instance
+		auto root = entities.front()->GetTransform_PtrRaw();
+		root->SetPosition(position);
+		root->SetRotation(rotation);
+
+		return entities.front();
+	}
+}
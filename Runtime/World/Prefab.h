@@ -0,0 +1,78 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ======================
+#include <memory>
+#include <vector>
+#include "../Resource/IResource.h"
+#include "../Math/Vector3.h"
+#include "../Math/Quaternion.h"
+//=================================
+
+namespace Directus
+{
+	class Entity;
+	class Material;
+	struct RenderableGeometry;
+
+	// A hierarchy of entities that can be instantiated many times. Instances share the
+	// prefab's geometry and materials instead of each one holding its own copy.
+	class ENGINE_CLASS Prefab : public IResource
+	{
+	public:
+		Prefab(Context* context);
+		~Prefab() = default;
+
+		//= RESOURCE INTERFACE =================================
+		bool LoadFromFile(const std::string& file_path) override;
+		bool SaveToFile(const std::string& file_path) override;
+		//======================================================
+
+		// Captures the hierarchy under root (only transforms and renderables)
+		bool CreateFromEntity(Entity* root);
+
+		// Creates a new instance of the hierarchy in the world and returns its root
+		std::shared_ptr<Entity> Instantiate(const Math::Vector3& position = Math::Vector3::Zero, const Math::Quaternion& rotation = Math::Quaternion::Identity) const;
+
+		unsigned int GetNodeCount() const { return static_cast<unsigned int>(m_nodes.size()); }
+
+	private:
+		struct Node
+		{
+			std::string name;
+			int parent = -1; // index into m_nodes, parents always come before their children
+			Math::Vector3 position;
+			Math::Quaternion rotation;
+			Math::Vector3 scale = Math::Vector3::One;
+			bool has_renderable	= false;
+			std::shared_ptr<const RenderableGeometry> geometry;
+			std::shared_ptr<Material> material;
+			bool material_default	= false;
+			bool cast_shadows		= true;
+			bool receive_shadows	= true;
+		};
+
+		std::vector<Node> m_nodes;
+		mutable std::shared_ptr<Material> m_material_default; // created by the first instance that needs it
+	};
+}
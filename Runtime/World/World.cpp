@@ -21,13 +21,17 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==========================
 #include "World.h"
+#include <algorithm>
 #include "Entity.h"
+#include "WorldStreaming.h"
+#include "Prefab.h"
 #include "Components/Transform.h"
 #include "Components/Camera.h"
 #include "Components/Light.h"
 #include "Components/Script.h"
 #include "Components/Skybox.h"
 #include "Components/AudioListener.h"
+#include "Components/Renderable.h"
 #include "../Core/Engine.h"
 #include "../Core/Stopwatch.h"
 #include "../Resource/ResourceCache.h"
@@ -36,6 +40,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Profiling/Profiler.h"
 #include "../Rendering/Renderer.h"
 #include "../Input/Input.h"
+#include "../Threading/Threading.h"
+#include "../Math/Ray.h"
+#include "../Math/RayHit.h"
 //=====================================
 
 //= NAMESPACES ================
@@ -45,13 +52,40 @@ using namespace Directus::Math;
 
 namespace Directus
 {
+	namespace
+	{
+		// World file container
+		const unsigned int g_world_magic	= 0x444C5257; // "WRLD"
+		const unsigned int g_world_version	= 2;
+
+		// How many frames something which was removed is kept alive for (the renderer is at most one frame behind)
+		const uint64_t g_epochs_in_flight	= 2;
+		// How many retired entities/components are freed per frame, so unloading a large world doesn't stall a single frame
+		const unsigned int g_retire_budget	= 512;
+
+		// Keeps the entities (from start onwards) which have all of the tags, without branching per entity
+		void filter_by_tags(vector<Entity*>* entities, const size_t start, const uint32_t tags)
+		{
+			if (tags == 0)
+				return;
+
+			auto count = start;
+			for (auto i = start; i < entities->size(); i++)
+			{
+				const auto entity	= (*entities)[i];
+				(*entities)[count]	= entity;
+				count				+= (entity->GetTags() & tags) == tags;
+			}
+			entities->resize(count);
+		}
+	}
+
 	World::World(Context* context) : ISubsystem(context)
 	{
-		m_isDirty	= true;
 		m_state		= Ticking;
+		m_streaming	= make_unique<WorldStreaming>(context, this);
 		
 		// Subscribe to events
-		SUBSCRIBE_TO_EVENT(Event_World_Resolve, [this](Variant) { m_isDirty = true; });
 		SUBSCRIBE_TO_EVENT(Event_World_Stop,	[this](Variant)	{ m_state = Idle; });
 		SUBSCRIBE_TO_EVENT(Event_World_Start,	[this](Variant)	{ m_state = Ticking; });
 	}
@@ -59,12 +93,15 @@ namespace Directus
 	World::~World()
 	{
 		Unload();
+		RetireFlush(true);
 	}
 
 	bool World::Initialize()
 	{
 		m_input		= m_context->GetSubsystem<Input>().get();
 		m_profiler	= m_context->GetSubsystem<Profiler>().get();
+		m_threading	= m_context->GetSubsystem<Threading>().get();
+		m_renderer	= m_context->GetSubsystem<Renderer>().get();
 
 		CreateCamera();
 		CreateSkybox();
@@ -75,12 +112,35 @@ namespace Directus
 
 	void World::Tick()
 	{	
-		if (m_state == Request_Loading)
+		// Free what was removed a few frames ago, nothing can be using it anymore
+		m_epoch++;
+		RetireFlush();
+
+		// Once the entities of an unloaded world are gone, so are the resources only they used.
+		// The flag is taken before looking at the queue, so a world unloaded in between raises it again.
+		if (m_sweep_pending.exchange(false))
 		{
-			m_state = Loading;
-			return;
+			bool retired_all;
+			{
+				lock_guard<mutex> lock(m_retired_mutex);
+				retired_all = m_retired.empty();
+			}
+
+			if (retired_all)
+			{
+				m_context->GetSubsystem<ResourceCache>()->Sweep();
+			}
+			else
+			{
+				m_sweep_pending = true;
+			}
 		}
 
+		// A world is being loaded by another thread
+		unique_lock<mutex> lock(m_load_mutex, try_to_lock);
+		if (!lock.owns_lock())
+			return;
+
 		if (m_state != Ticking)
 			return;
 
@@ -109,39 +169,59 @@ namespace Directus
 					entity->Stop();
 				}
 			}
-			// Tick
+			// Tick - serial phase, components which can touch other entities or the hierarchy (e.g. scripts)
 			for (const auto& entity : m_entitiesPrimary)
 			{
-				entity->Tick();
+				entity->Tick(false);
 			}
-		}
 
-		TIME_BLOCK_END(m_profiler);
+			// Tick - parallel phase, components which only touch their own entity
+			m_threading->AddTaskLoop([this](unsigned int start, unsigned int end)
+			{
+				for (auto i = start; i < end; i++)
+				{
+					m_entitiesPrimary[i]->Tick(true);
+				}
+			}, static_cast<unsigned int>(m_entitiesPrimary.size()));
+		}
 
-		if (m_isDirty)
+		// Stream cells in/out around the camera
+		if (const auto camera = m_renderer->GetCamera())
 		{
-			m_entitiesSecondary = m_entitiesPrimary;
-			// Submit to the Renderer
-			FIRE_EVENT_DATA(Event_World_Submit, m_entitiesSecondary);
-			m_isDirty = false;
+			m_streaming->Tick(camera->GetTransform()->GetPosition());
 		}
+
+		TIME_BLOCK_END(m_profiler);
 	}
 
 	void World::Unload()
 	{
 		FIRE_EVENT(Event_World_Unload);
 
+		// The entities are freed once the renderer (which keeps its own references until it processes the unload) has moved on
+		{
+			lock_guard<mutex> lock(m_retired_mutex);
+			for (auto& entity : m_entitiesPrimary)
+			{
+				m_retired.push_back({ m_epoch, move(entity), nullptr });
+			}
+		}
 		m_entitiesPrimary.clear();
 		m_entitiesPrimary.shrink_to_fit();
+		m_masks_dirty	= true;
+		m_sweep_pending	= true;
+		m_streaming->Clear();
 
-		m_isDirty = true;
-		
-		// Don't clear secondary m_entitiesSecondary as they might be used by the renderer
+		{
+			lock_guard<mutex> lock(m_spatial_mutex);
+			m_spatial_pending.clear();
+			m_octree.Clear();
+		}
 	}
 	//=========================================================================================================
 
 	//= I/O ===================================================================================================
-	bool World::SaveToFile(const string& filePathIn)
+	bool World::SaveToFile(const string& filePathIn, const bool background)
 	{
 		ProgressReport::Get().Reset(g_progress_Scene);
 		ProgressReport::Get().SetIsLoading(g_progress_Scene, true);
@@ -158,43 +238,94 @@ namespace Directus
 		// Save any in-memory changes done to resources while running.
 		m_context->GetSubsystem<ResourceCache>()->SaveResourcesToFiles();
 
-		// Create a prefab file
-		auto file = make_unique<FileStream>(file_path, FileStreamMode_Write);
+		// The world is serialized into memory (a snapshot), only writing it to disk happens in the background
+		auto file = make_shared<FileStream>(file_path, FileStreamMode_WriteDeferred);
 		if (!file->IsOpen())
 		{
 			return false;
 		}
 
-		// Save currently loaded resource paths
+		// Only save root entities as they will also save their descendants
+		auto roots = EntitiesGetRoots();
+
+		// When streaming, most roots go into their cell's file and only the rest into the world file
+		vector<shared_ptr<Entity>> roots_persistent;
 		vector<string> file_paths;
-		m_context->GetSubsystem<ResourceCache>()->GetResourceFilePaths(file_paths);
-		file->Write(file_paths);
+		if (m_streaming->IsEnabled())
+		{
+			m_streaming->SaveCells(file_path, roots, &roots_persistent);
+			file_paths = WorldStreaming::GetResourcePaths(roots_persistent);
+		}
+		else
+		{
+			roots_persistent = roots;
+			m_context->GetSubsystem<ResourceCache>()->GetResourceFilePaths(file_paths);
+		}
 
-		//= Save entities ============================
-		// Only save root entities as they will also save their descendants
-		auto rootentities = EntitiesGetRoots();
+		// Header
+		file->Write(g_world_magic);
+		file->Write(g_world_version);
 
-		// 1st - entity count
-		const auto root_entity_count = static_cast<unsigned int>(rootentities.size());
-		file->Write(root_entity_count);
+		// Chunks, where each one starts and ends is recorded in the table of contents
+		vector<WorldChunk> chunks;
+		const auto chunk_begin = [&file, &chunks](const WorldChunk_Type type, const unsigned int id)
+		{
+			WorldChunk chunk;
+			chunk.type		= type;
+			chunk.id		= id;
+			chunk.offset	= file->GetPosition();
+			chunks.emplace_back(chunk);
+		};
+		const auto chunk_end = [&file, &chunks]() { chunks.back().size = file->GetPosition() - chunks.back().offset; };
+
+		// 1st - resource paths
+		chunk_begin(WorldChunk_Resources, 0);
+		file->Write(file_paths);
+		chunk_end();
 
-		// 2nd - entity IDs
-		for (const auto& root : rootentities)
+		// 2nd - entities, one chunk per root
+		for (const auto& root : roots_persistent)
 		{
-			file->Write(root->GetId());
+			chunk_begin(WorldChunk_Entity, root->GetId());
+			root->Serialize(file.get());
+			chunk_end();
 		}
 
-		// 3rd - entities
-		for (const auto& root : rootentities)
+		// 3rd - cells
+		chunk_begin(WorldChunk_Cells, 0);
+		m_streaming->SaveTable(file.get());
+		chunk_end();
+
+		// Table of contents, followed by where it starts (at a known distance from the end of the file)
+		const uint64_t toc_offset = file->GetPosition();
+		file->Write(static_cast<unsigned int>(chunks.size()));
+		for (const auto& chunk : chunks)
 		{
-			root->Serialize(file.get());
+			file->Write(chunk.type);
+			file->Write(chunk.id);
+			file->Write(chunk.offset);
+			file->Write(chunk.size);
 		}
-		//==============================================
+		file->Write(toc_offset);
+		file->Write(g_world_magic);
 
-		ProgressReport::Get().SetIsLoading(g_progress_Scene, false);
-		LOG_INFO("Saving took " + to_string(static_cast<int>(timer.GetElapsedTimeMs())) + " ms");	
-		FIRE_EVENT(Event_World_Saved);
+		// Write the snapshot, completion is signalled with Event_World_Saved
+		auto write = [file, timer]() mutable
+		{
+			const auto written = file->Close();
+			if (written)
+			{
+				LOG_INFO("Saving took " + to_string(static_cast<int>(timer.GetElapsedTimeMs())) + " ms");
+			}
+			ProgressReport::Get().SetIsLoading(g_progress_Scene, false);
+			FIRE_EVENT(Event_World_Saved);
+			return written;
+		};
 
+		if (!background)
+			return write();
+
+		m_threading->AddTask([write]() mutable { write(); });
 		return true;
 	}
 
@@ -206,8 +337,9 @@ namespace Directus
 			return false;
 		}
 
-		// Thread safety: Wait for scene and the renderer to stop the entities (could do double buffering in the future)
-		while (m_state != Loading || Renderer::IsRendering()) { m_state = Request_Loading; this_thread::sleep_for(chrono::milliseconds(16)); }
+		// Thread safety: The world doesn't tick while loading. The renderer doesn't need to be waited
+		// for, unloaded entities stay alive until it's done with them (see Retire()).
+		lock_guard<mutex> lock(m_load_mutex);
 
 		ProgressReport::Get().Reset(g_progress_Scene);
 		ProgressReport::Get().SetIsLoading(g_progress_Scene, true);
@@ -215,69 +347,291 @@ namespace Directus
 
 		Unload();
 
-		// Read all the resource file paths
-		auto file = make_unique<FileStream>(file_path, FileStreamMode_Read);
+		auto file = make_unique<FileStream>(file_path, FileStreamMode_ReadMapped);
 		if (!file->IsOpen())
 			return false;
 
 		Stopwatch timer;
 
-		vector<string> resource_paths;
-		file->Read(&resource_paths);
+		// Version 1 files are a sequential stream, without a header
+		if (file->ReadAs<unsigned int>() != g_world_magic)
+		{
+			file->Seek(0);
+			LoadFromFileLegacy(file.get());
+		}
+		else
+		{
+			vector<WorldChunk> chunks;
+			if (!ReadTableOfContents(file.get(), &chunks))
+			{
+				ProgressReport::Get().SetIsLoading(g_progress_Scene, false);
+				return false;
+			}
 
-		ProgressReport::Get().SetJobCount(g_progress_Scene, static_cast<unsigned int>(resource_paths.size()));
+			// Resources start loading in the background, entities only need them to be cached
+			for (const auto& chunk : chunks)
+			{
+				if (chunk.type != WorldChunk_Resources)
+					continue;
 
-		// Load all the resources
-		auto resource_mng = m_context->GetSubsystem<ResourceCache>();
-		for (const auto& resource_path : resource_paths)
-		{
-			if (FileSystem::IsEngineModelFile(resource_path))
+				vector<string> resource_paths;
+				file->Seek(chunk.offset);
+				file->Read(&resource_paths);
+				ResourcesLoadAsync(resource_paths);
+			}
+
+			// Entities, announced all at once when they and their resources are done
 			{
-				resource_mng->Load<Model>(resource_path);
+				BatchScope batch(this);
+				for (const auto& chunk : chunks)
+				{
+					if (chunk.type != WorldChunk_Entity)
+						continue;
+
+					file->Seek(chunk.offset);
+					auto entity = EntityCreate();
+					entity->SetId(chunk.id);
+					entity->Deserialize(file.get(), nullptr);
+				}
+				ResourcesWait();
 			}
 
-			if (FileSystem::IsEngineMaterialFile(resource_path))
+			// Cell table, the cells themselves get streamed in by Tick()
+			for (const auto& chunk : chunks)
 			{
-				resource_mng->Load<Material>(resource_path);
+				if (chunk.type != WorldChunk_Cells)
+					continue;
+
+				file->Seek(chunk.offset);
+				m_streaming->LoadTable(file.get());
 			}
+		}
+
+		ProgressReport::Get().SetIsLoading(g_progress_Scene, false);	
+		LOG_INFO("Loading took " + to_string(static_cast<int>(timer.GetElapsedTimeMs())) + " ms");	
 
-			if (FileSystem::IsEngineTextureFile(resource_path))
+		FIRE_EVENT(Event_World_Loaded);
+		return true;
+	}
+
+	bool World::LoadFromFile(const string& file_path, const vector<unsigned int>& root_ids, vector<shared_ptr<Entity>>* roots)
+	{
+		lock_guard<mutex> lock(m_load_mutex);
+
+		auto file = make_unique<FileStream>(file_path, FileStreamMode_ReadMapped);
+		if (!file->IsOpen())
+			return false;
+
+		vector<WorldChunk> chunks;
+		if (file->ReadAs<unsigned int>() != g_world_magic || !ReadTableOfContents(file.get(), &chunks))
+		{
+			LOGF_ERROR("\"%s\" has no table of contents, partial loading requires a version %d world file.", file_path.c_str(), g_world_version);
+			return false;
+		}
+
+		for (const auto& chunk : chunks)
+		{
+			if (chunk.type != WorldChunk_Resources)
+				continue;
+
+			vector<string> resource_paths;
+			file->Seek(chunk.offset);
+			file->Read(&resource_paths);
+			ResourcesLoadAsync(resource_paths);
+		}
+
+		// Everything else is skipped
+		BatchScope batch(this);
+		for (const auto& chunk : chunks)
+		{
+			if (chunk.type != WorldChunk_Entity || find(root_ids.begin(), root_ids.end(), chunk.id) == root_ids.end())
+				continue;
+
+			file->Seek(chunk.offset);
+			auto entity = EntityCreate();
+			entity->SetId(chunk.id);
+			entity->Deserialize(file.get(), nullptr);
+			roots->emplace_back(entity);
+		}
+		ResourcesWait();
+
+		return true;
+	}
+
+	bool World::UpgradeFile(const string& file_path)
+	{
+		{
+			auto file = make_unique<FileStream>(file_path, FileStreamMode_ReadMapped);
+			if (!file->IsOpen())
+				return false;
+
+			if (file->ReadAs<unsigned int>() == g_world_magic && file->ReadAs<unsigned int>() == g_world_version)
+				return true;
+		}
+
+		// Only the world can read a version 1 file (component data has no recorded size), so it goes through the
+		// current world. It's written before returning, the caller can use the file straight away.
+		LOGF_INFO("Upgrading \"%s\" to version %d", file_path.c_str(), g_world_version);
+		return LoadFromFile(file_path) && SaveToFile(file_path, false);
+	}
+
+	bool World::ReadTableOfContents(FileStream* file, vector<WorldChunk>* chunks)
+	{
+		// Header
+		file->Seek(0);
+		const auto size = file->GetSize();
+		if (size < 2 * sizeof(unsigned int) + sizeof(uint64_t) + sizeof(unsigned int) || file->ReadAs<unsigned int>() != g_world_magic)
+		{
+			LOG_ERROR("Not a world file");
+			return false;
+		}
+
+		const auto version = file->ReadAs<unsigned int>();
+		if (version > g_world_version)
+		{
+			LOGF_ERROR("World file version %d is newer than the supported version %d", version, g_world_version);
+			return false;
+		}
+
+		// Where the table of contents starts is at the end of the file
+		const uint64_t header_size	= 2 * sizeof(unsigned int);
+		const uint64_t toc_end		= size - sizeof(uint64_t) - sizeof(unsigned int);
+		file->Seek(toc_end);
+		uint64_t toc_offset = 0;
+		file->Read(&toc_offset);
+		if (file->ReadAs<unsigned int>() != g_world_magic || toc_offset < header_size || toc_offset > toc_end - sizeof(unsigned int))
+		{
+			LOG_ERROR("The world file is truncated or corrupt");
+			return false;
+		}
+
+		// Table of contents, it has to fill the space up to the end exactly and every chunk has to lie before it
+		const uint64_t chunk_entry_size = 2 * sizeof(unsigned int) + 2 * sizeof(uint64_t);
+		file->Seek(toc_offset);
+		const auto chunk_count = file->ReadAs<unsigned int>();
+		if (chunk_count != (toc_end - toc_offset - sizeof(unsigned int)) / chunk_entry_size || (toc_end - toc_offset - sizeof(unsigned int)) % chunk_entry_size != 0)
+		{
+			LOG_ERROR("The world file's table of contents is corrupt");
+			return false;
+		}
+
+		chunks->resize(chunk_count);
+		for (auto& chunk : *chunks)
+		{
+			file->Read(&chunk.type);
+			file->Read(&chunk.id);
+			file->Read(&chunk.offset);
+			file->Read(&chunk.size);
+
+			if (chunk.offset < header_size || chunk.offset > toc_offset || chunk.size > toc_offset - chunk.offset)
 			{
-				resource_mng->Load<RHI_Texture>(resource_path);
+				LOG_ERROR("The world file's table of contents is corrupt");
+				chunks->clear();
+				return false;
 			}
+		}
+
+		return true;
+	}
+
+	void World::ResourcesLoadAsync(const vector<string>& resource_paths)
+	{
+		auto resource_cache = m_context->GetSubsystem<ResourceCache>();
+
+		// Textures first, they take the longest
+		m_resources_loading.clear();
+		for (const auto& resource_path : resource_paths)
+		{
+			if (FileSystem::IsEngineTextureFile(resource_path))	m_resources_loading.emplace_back(resource_cache->LoadAsync<RHI_Texture>(resource_path));
+		}
+		for (const auto& resource_path : resource_paths)
+		{
+			if (FileSystem::IsEngineMaterialFile(resource_path))	m_resources_loading.emplace_back(resource_cache->LoadAsync<Material>(resource_path));
+			if (FileSystem::IsEngineModelFile(resource_path))		m_resources_loading.emplace_back(resource_cache->LoadAsync<Model>(resource_path));
+		}
+		m_resources_loading.erase(remove(m_resources_loading.begin(), m_resources_loading.end(), nullptr), m_resources_loading.end());
+
+		ProgressReport::Get().SetJobCount(g_progress_Scene, static_cast<int>(m_resources_loading.size()));
+	}
 
+	void World::ResourcesWait()
+	{
+		// Anything the job system hasn't picked up yet is loaded here
+		auto resource_cache = m_context->GetSubsystem<ResourceCache>();
+		for (const auto& resource : m_resources_loading)
+		{
+			resource_cache->Wait(resource);
 			ProgressReport::Get().IncrementJobsDone(g_progress_Scene);
 		}
+		m_resources_loading.clear();
+	}
+
+	bool World::LoadFromFileLegacy(FileStream* file)
+	{
+		// 1st - resource paths
+		vector<string> resource_paths;
+		file->Read(&resource_paths);
+		ResourcesLoadAsync(resource_paths);
+
+		// 2nd - entities, announced when their resources are done
+		{
+			BatchScope batch(this);
+			vector<shared_ptr<Entity>> roots;
+			EntitiesDeserialize(file, &roots);
+			ResourcesWait();
+		}
+
+		// 3rd - cells, worlds saved before streaming existed end before the table
+		if (!file->IsEnd())
+		{
+			m_streaming->LoadTable(file);
+		}
+
+		return true;
+	}
+
+	void World::EntitiesSerialize(FileStream* file, const vector<shared_ptr<Entity>>& roots)
+	{
+		// 1st - entity count
+		file->Write(static_cast<unsigned int>(roots.size()));
+
+		// 2nd - entity IDs
+		for (const auto& root : roots)
+		{
+			file->Write(root->GetId());
+		}
+
+		// 3rd - entities
+		for (const auto& root : roots)
+		{
+			root->Serialize(file);
+		}
+	}
+
+	void World::EntitiesDeserialize(FileStream* file, vector<shared_ptr<Entity>>* roots)
+	{
+		// Announce all the new entities at once, when loading is done
+		BatchScope batch(this);
 
-		//= Load entities ============================	
 		// 1st - Root entity count
-		const int root_entity_count = file->ReadAs<unsigned int>();
+		const auto root_count = file->ReadAs<unsigned int>();
+		roots->reserve(roots->size() + root_count);
 
 		// 2nd - Root entity IDs
-		for (auto i = 0; i < root_entity_count; i++)
+		for (unsigned int i = 0; i < root_count; i++)
 		{
-			auto& entity = EntityCreate();
+			auto entity = EntityCreate();
 			entity->SetId(file->ReadAs<unsigned int>());
+			roots->emplace_back(entity);
 		}
 
 		// 3rd - entities
-		// It's important to loop with root_entity_count
-		// as the vector size will increase as we deserialize
-		// entities. This is because a entity will also
-		// deserialize their descendants.
-		for (auto i = 0; i < root_entity_count; i++)
+		// Only the roots are deserialized here, as they will
+		// also deserialize (and create) their descendants.
+		for (auto i = roots->size() - root_count; i < roots->size(); i++)
 		{
-			m_entitiesPrimary[i]->Deserialize(file.get(), nullptr);
+			(*roots)[i]->Deserialize(file, nullptr);
 		}
-		//==============================================
-
-		m_isDirty	= true;
-		m_state		= Ticking;
-		ProgressReport::Get().SetIsLoading(g_progress_Scene, false);	
-		LOG_INFO("Loading took " + to_string(static_cast<int>(timer.GetElapsedTimeMs())) + " ms");	
-
-		FIRE_EVENT(Event_World_Loaded);
-		return true;
 	}
 	//===================================================================================================
 
@@ -286,14 +640,34 @@ namespace Directus
 	{
 		auto entity = make_shared<Entity>(m_context);
 		entity->Initialize(entity->AddComponent<Transform>().get());
+		SpatialReset(entity.get());
+		m_masks_dirty = true;
 		return m_entitiesPrimary.emplace_back(entity);
 	}
 
+	shared_ptr<Entity> World::PrefabInstantiate(const Prefab& prefab)
+	{
+		// Same as importing a model, the entities are created while nothing ticks them
+		FIRE_EVENT(Event_World_Stop);
+		shared_ptr<Entity> root;
+		{
+			lock_guard<mutex> lock(m_load_mutex);
+			root = prefab.Instantiate();
+		}
+		FIRE_EVENT(Event_World_Start);
+
+		return root;
+	}
+
 	shared_ptr<Entity>& World::EntityAdd(const shared_ptr<Entity>& entity)
 	{
 		if (!entity)
 			return m_entity_empty;
 
+		SpatialReset(entity.get());
+		EntityResolve(entity);
+		m_masks_dirty = true;
+
 		return m_entitiesPrimary.emplace_back(entity);
 	}
 
@@ -321,13 +695,27 @@ namespace Directus
 		// Keep a reference to it's parent (in case it has one)
 		auto parent = entity->GetTransform_PtrRaw()->GetParent();
 
+		// Let the renderer know before the entity gets erased (the parameter might be a reference to it)
+		{
+			// A change collected by an open batch would otherwise bring it back
+			lock_guard<mutex> lock(m_batch_mutex);
+			m_batch_entities.erase(entity.get());
+		}
+		FIRE_EVENT_DATA(Event_World_EntityRemoved, entity);
+		{
+			lock_guard<mutex> lock(m_spatial_mutex);
+			m_spatial_pending[entity.get()] = true;
+		}
+
 		// Remove this entity
 		for (auto it = m_entitiesPrimary.begin(); it < m_entitiesPrimary.end();)
 		{
 			const auto temp = *it;
 			if (temp->GetId() == entity->GetId())
 			{
+				Retire(temp);
 				it = m_entitiesPrimary.erase(it);
+				m_masks_dirty = true;
 				break;
 			}
 			++it;
@@ -339,7 +727,27 @@ namespace Directus
 			parent->AcquireChildren();
 		}
 
-		m_isDirty = true;
+		EntityResolve(nullptr);
+	}
+
+	void World::EntitiesReloadScripts(const string& file_path)
+	{
+		// A load is replacing the entities, they will get the current script anyway
+		unique_lock<mutex> lock(m_load_mutex, try_to_lock);
+		if (!lock.owns_lock())
+			return;
+
+		for (const auto& entity : m_entitiesPrimary)
+		{
+			for (const auto& script : entity->GetComponents<Script>())
+			{
+				const auto script_path = script->GetScriptPath();
+				if (script_path != NOT_ASSIGNED && FileSystem::GetRelativeFilePath(script_path) == file_path)
+				{
+					script->SetScript(script_path);
+				}
+			}
+		}
 	}
 
 	vector<shared_ptr<Entity>> World::EntitiesGetRoots()
@@ -379,6 +787,233 @@ namespace Directus
 	}
 	//===================================================================================================
 
+	//= FILTERED ITERATION ============================================================================
+	void World::EntitiesGet(const uint32_t tags, const uint32_t layers, vector<Entity*>* entities)
+	{
+		lock_guard<mutex> lock(m_masks_mutex);
+
+		// Re-pack the masks, they change far less often than they are iterated
+		if (m_masks_dirty.exchange(false))
+		{
+			m_masks.resize(m_entitiesPrimary.size());
+			m_masks_entities.resize(m_entitiesPrimary.size());
+			for (size_t i = 0; i < m_entitiesPrimary.size(); i++)
+			{
+				m_masks[i]			= { m_entitiesPrimary[i]->GetTags(), m_entitiesPrimary[i]->GetLayers() };
+				m_masks_entities[i]	= m_entitiesPrimary[i].get();
+			}
+		}
+
+		// Branch-free compaction of the matching entities
+		const auto start = entities->size();
+		entities->resize(start + m_masks.size());
+		auto count = start;
+		for (size_t i = 0; i < m_masks.size(); i++)
+		{
+			(*entities)[count]	= m_masks_entities[i];
+			count				+= ((m_masks[i].tags & tags) == tags) & ((m_masks[i].layers & layers) != 0);
+		}
+		entities->resize(count);
+	}
+	//===================================================================================================
+
+	//= DEFERRED DESTRUCTION ==========================================================================
+	void World::Retire(const shared_ptr<Entity>& entity)
+	{
+		if (!entity)
+			return;
+
+		lock_guard<mutex> lock(m_retired_mutex);
+		m_retired.push_back({ m_epoch, entity, nullptr });
+	}
+
+	void World::Retire(const shared_ptr<IComponent>& component)
+	{
+		if (!component)
+			return;
+
+		lock_guard<mutex> lock(m_retired_mutex);
+		m_retired.push_back({ m_epoch, nullptr, component });
+	}
+	//===================================================================================================
+
+	//= RESOLVE =======================================================================================
+	void World::EntityResolve(const shared_ptr<Entity>& entity)
+	{
+		// Components might have been added or removed, so the entity might have to enter or leave the spatial index
+		if (entity)
+		{
+			SpatialUpdate(entity.get());
+		}
+
+		// Checked under the lock, so a batch ending on another thread can't miss the change
+		{
+			lock_guard<mutex> lock(m_batch_mutex);
+			if (m_batch_depth > 0)
+			{
+				m_batch_resolve = true;
+				if (entity)
+				{
+					m_batch_entities[entity.get()] = entity;
+				}
+				return;
+			}
+		}
+
+		if (entity)
+		{
+			FIRE_EVENT_DATA(Event_World_EntityChanged, entity);
+		}
+		FIRE_EVENT(Event_World_Resolve);
+	}
+
+	void World::BatchBegin()
+	{
+		lock_guard<mutex> lock(m_batch_mutex);
+		m_batch_depth++;
+	}
+
+	void World::BatchEnd()
+	{
+		// Grab what was collected, once the outermost batch ends
+		unordered_map<Entity*, shared_ptr<Entity>> entities;
+		bool resolve = false;
+		{
+			lock_guard<mutex> lock(m_batch_mutex);
+			if (--m_batch_depth > 0)
+				return;
+
+			entities.swap(m_batch_entities);
+			resolve			= m_batch_resolve;
+			m_batch_resolve	= false;
+		}
+
+		for (const auto& entity : entities)
+		{
+			FIRE_EVENT_DATA(Event_World_EntityChanged, entity.second);
+		}
+
+		if (resolve)
+		{
+			FIRE_EVENT(Event_World_Resolve);
+		}
+	}
+	//================================================================================================
+
+	//= SPATIAL QUERIES ==============================================================================
+	void World::SpatialUpdate(Entity* entity)
+	{
+		if (!entity)
+			return;
+
+		// A pending removal always wins, the entity might be kept alive by someone else while not being part of the world anymore
+		lock_guard<mutex> lock(m_spatial_mutex);
+		m_spatial_pending.emplace(entity, false);
+	}
+
+	void World::QueryFrustum(const Frustum& frustum, vector<Entity*>* entities, const uint32_t tags)
+	{
+		lock_guard<mutex> lock(m_spatial_mutex);
+		SpatialFlush();
+		const auto start = entities->size();
+		m_octree.QueryFrustum(frustum, entities);
+		filter_by_tags(entities, start, tags);
+	}
+
+	void World::QueryAABB(const BoundingBox& box, vector<Entity*>* entities, const uint32_t tags)
+	{
+		lock_guard<mutex> lock(m_spatial_mutex);
+		SpatialFlush();
+		const auto start = entities->size();
+		m_octree.QueryAABB(box, entities);
+		filter_by_tags(entities, start, tags);
+	}
+
+	void World::QuerySphere(const Vector3& center, const float radius, vector<Entity*>* entities, const uint32_t tags)
+	{
+		lock_guard<mutex> lock(m_spatial_mutex);
+		SpatialFlush();
+		const auto start = entities->size();
+		m_octree.QuerySphere(center, radius, entities);
+		filter_by_tags(entities, start, tags);
+	}
+
+	vector<RayHit> World::Raycast(const Ray& ray, const uint32_t tags)
+	{
+		vector<pair<Entity*, float>> candidates;
+		vector<RayHit> hits;
+		{
+			lock_guard<mutex> lock(m_spatial_mutex);
+			SpatialFlush();
+			m_octree.Raycast(ray, &candidates);
+
+			// Only entities which are still in the index get here, so they are alive
+			hits.reserve(candidates.size());
+			for (const auto& candidate : candidates)
+			{
+				if (!candidate.first->HasTags(tags))
+					continue;
+
+				hits.emplace_back(candidate.first->GetPtrShared(), candidate.second, candidate.second == 0.0f);
+			}
+		}
+
+		// Sort by distance (ascending)
+		sort(hits.begin(), hits.end(), [](const RayHit& a, const RayHit& b)
+		{
+			return a.m_distance < b.m_distance;
+		});
+
+		return hits;
+	}
+
+	void World::RetireFlush(const bool all)
+	{
+		// Collect under the lock, free outside of it
+		vector<Retired> expired;
+		{
+			lock_guard<mutex> lock(m_retired_mutex);
+			while (!m_retired.empty() && (all || (m_retired.front().epoch + g_epochs_in_flight <= m_epoch && expired.size() < g_retire_budget)))
+			{
+				expired.emplace_back(move(m_retired.front()));
+				m_retired.pop_front();
+			}
+		}
+	}
+
+	void World::SpatialReset(Entity* entity)
+	{
+		// The entity is part of the world, so a removal pending for a previous entity at the same address doesn't apply
+		lock_guard<mutex> lock(m_spatial_mutex);
+		m_spatial_pending[entity] = false;
+	}
+
+	void World::SpatialFlush()
+	{
+		// Expects m_spatial_mutex to be locked
+		for (const auto& pending : m_spatial_pending)
+		{
+			auto entity = pending.first;
+			if (pending.second)
+			{
+				m_octree.Remove(entity);
+				continue;
+			}
+
+			// Only renderables are indexed, the skybox is everywhere so it's left out
+			auto renderable = entity->GetRenderable_PtrRaw();
+			if (!renderable || !static_cast<const Renderable*>(renderable)->GeometryAabb().Defined() || entity->HasComponent<Skybox>())
+			{
+				m_octree.Remove(entity);
+				continue;
+			}
+
+			m_octree.Insert(entity, renderable->GeometryAabb());
+		}
+		m_spatial_pending.clear();
+	}
+	//================================================================================================
+
 	//= COMMON ENTITY CREATION ========================================================================
 	shared_ptr<Entity>& World::CreateSkybox()
 	{
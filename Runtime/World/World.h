@@ -23,24 +23,55 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ==================
 #include <vector>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
 #include "../Core/EngineDefs.h"
 #include "../Core/ISubsystem.h"
+#include "Octree.h"
 //=============================
 
 namespace Directus
 {
 	class Entity;
+	class IComponent;
+	class IResource;
 	class Light;
 	class Input;
 	class Profiler;
+	class Threading;
+	class Renderer;
+	class FileStream;
+	class WorldStreaming;
+	class Prefab;
+
+	namespace Math
+	{
+		class RayHit;
+	}
+
+	// World files (version 2 onwards) are a header, chunks and a table of contents, so they can be read out of order
+	enum WorldChunk_Type
+	{
+		WorldChunk_Resources,	// the resource paths
+		WorldChunk_Entity,		// a root entity and its descendants
+		WorldChunk_Cells		// the streaming cell table
+	};
+
+	struct WorldChunk
+	{
+		unsigned int type	= WorldChunk_Resources;
+		unsigned int id		= 0; // the root entity ID, for entity chunks
+		uint64_t offset		= 0;
+		uint64_t size		= 0;
+	};
 
 	enum Scene_State
 	{
 		Ticking,
-		Idle,
-		Request_Loading,
-		Loading
+		Idle
 	};
 
 	class ENGINE_CLASS World : public ISubsystem
@@ -57,10 +88,21 @@ namespace Directus
 		void Unload();
 
 		//= IO ========================================
-		bool SaveToFile(const std::string& filePath);
+		// The world is written in the background (Event_World_Saved fires once it's done), unless background is false
+		bool SaveToFile(const std::string& filePath, bool background = true);
 		bool LoadFromFile(const std::string& file_path);
+		// Loads only some root entities (and their descendants) of a world file into the current world
+		bool LoadFromFile(const std::string& file_path, const std::vector<unsigned int>& root_ids, std::vector<std::shared_ptr<Entity>>* roots);
+		// Re-saves a world file of an older version in the current version and returns once it's written (the file becomes the current world)
+		bool UpgradeFile(const std::string& file_path);
+		static bool ReadTableOfContents(FileStream* file, std::vector<WorldChunk>* chunks);
+		// Writes/reads root entities (and their descendants)
+		void EntitiesSerialize(FileStream* file, const std::vector<std::shared_ptr<Entity>>& roots);
+		void EntitiesDeserialize(FileStream* file, std::vector<std::shared_ptr<Entity>>* roots);
 		//=============================================
 
+		WorldStreaming* GetStreaming() const { return m_streaming.get(); }
+
 		//= Entity HELPER FUNCTIONS ===============================================================
 		std::shared_ptr<Entity>& EntityCreate();
 		std::shared_ptr<Entity>& EntityAdd(const std::shared_ptr<Entity>& entity);
@@ -71,24 +113,123 @@ namespace Directus
 		const std::shared_ptr<Entity>& EntityGetByName(const std::string& name);
 		const std::shared_ptr<Entity>& EntityGetById(unsigned int id);
 		int Entity_GetCount() { return (int)m_entitiesPrimary.size(); }
+		// Instantiates a prefab at the origin from any thread, the world doesn't tick in the meantime (like while loading)
+		std::shared_ptr<Entity> PrefabInstantiate(const Prefab& prefab);
+		// Instantiates the scripts loaded from a (relative) path again, e.g. after the file changed
+		void EntitiesReloadScripts(const std::string& file_path);
+		//=========================================================================================
+
+		//= FILTERED ITERATION ====================================================================
+		// Gets the entities which have all of the tags and are in any of the layers (tested against a packed array of masks)
+		void EntitiesGet(uint32_t tags, uint32_t layers, std::vector<Entity*>* entities);
+		// Entities call this when their tags or layers change
+		void EntitiesMasksDirty() { m_masks_dirty = true; }
+		//=========================================================================================
+
+		//= RESOLVE ===============================================================================
+		// Announces that an entity's components have changed (deferred while a batch is open)
+		void EntityResolve(const std::shared_ptr<Entity>& entity);
+
+		// While at least one batch is open, entity changes are collected and announced
+		// only once, with a single resolve, when the last batch closes.
+		void BatchBegin();
+		void BatchEnd();
+
+		class BatchScope
+		{
+		public:
+			BatchScope(World* world) : m_world(world)	{ m_world->BatchBegin(); }
+			~BatchScope()								{ m_world->BatchEnd(); }
+			BatchScope(const BatchScope&) = delete;
+			BatchScope& operator=(const BatchScope&) = delete;
+
+		private:
+			World* m_world;
+		};
+		//=========================================================================================
+
+		//= DEFERRED DESTRUCTION ==================================================================
+		// Removed entities and components are kept alive until no frame (renderer, jobs) can still be using them
+		void Retire(const std::shared_ptr<Entity>& entity);
+		void Retire(const std::shared_ptr<IComponent>& component);
+		uint64_t GetEpoch() const { return m_epoch; }
+		//=========================================================================================
+
+		//= SPATIAL QUERIES =======================================================================
+		// Queues an entity to be re-placed in the spatial index, this happens lazily on the next query.
+		void SpatialUpdate(Entity* entity);
+		// Only entities which have all of the tags are returned
+		void QueryFrustum(const Math::Frustum& frustum, std::vector<Entity*>* entities, uint32_t tags = 0);
+		void QueryAABB(const Math::BoundingBox& box, std::vector<Entity*>* entities, uint32_t tags = 0);
+		void QuerySphere(const Math::Vector3& center, float radius, std::vector<Entity*>* entities, uint32_t tags = 0);
+		// Returns all the entities hit by the ray, sorted by distance (ascending)
+		std::vector<Math::RayHit> Raycast(const Math::Ray& ray, uint32_t tags = 0);
 		//=========================================================================================
 
 	private:
+		// Resources are cached immediately and loaded on the job system, entities can reference them while they load
+		void ResourcesLoadAsync(const std::vector<std::string>& resource_paths);
+		void ResourcesWait();
+		bool LoadFromFileLegacy(FileStream* file);
+		void SpatialReset(Entity* entity);
+		void SpatialFlush();
+		void RetireFlush(bool all = false);
+
 		//= COMMON ENTITY CREATION =======================
 		std::shared_ptr<Entity>& CreateSkybox();
 		std::shared_ptr<Entity> CreateCamera();
 		std::shared_ptr<Entity>& CreateDirectionalLight();
 		//===============================================
 
-		// Double-buffered entities
 		std::vector<std::shared_ptr<Entity>> m_entitiesPrimary;
-		std::vector<std::shared_ptr<Entity>> m_entitiesSecondary;
 
 		std::shared_ptr<Entity> m_entity_empty;
 		Input* m_input;
 		Profiler* m_profiler;
+		Threading* m_threading;
+		Renderer* m_renderer;
 		bool m_wasInEditorMode;
-		bool m_isDirty;
+		std::unique_ptr<WorldStreaming> m_streaming;
+
+		// Batching
+		unsigned int m_batch_depth = 0;
+		std::unordered_map<Entity*, std::shared_ptr<Entity>> m_batch_entities;
+		bool m_batch_resolve = false;
+		std::mutex m_batch_mutex; // guards the three above
+
+		// Spatial index
+		Octree m_octree;
+		std::unordered_map<Entity*, bool> m_spatial_pending; // true = removed
+		std::mutex m_spatial_mutex;
+
+		// Packed tag/layer masks, parallel to m_masks_entities and rebuilt when anything changes
+		struct EntityMask
+		{
+			uint32_t tags;
+			uint32_t layers;
+		};
+		std::vector<EntityMask> m_masks;
+		std::vector<Entity*> m_masks_entities;
+		std::atomic<bool> m_masks_dirty = true;
+		std::mutex m_masks_mutex;
+
+		// Deferred destruction
+		struct Retired
+		{
+			uint64_t epoch;
+			std::shared_ptr<Entity> entity;
+			std::shared_ptr<IComponent> component;
+		};
+		std::deque<Retired> m_retired;
+		std::mutex m_retired_mutex;
+		std::atomic<uint64_t> m_epoch = 0;
+		// Set by an unload, the resource cache is swept once its entities are freed
+		std::atomic<bool> m_sweep_pending = false;
+
+		// Held by a load for its whole duration, the world doesn't tick meanwhile
+		std::mutex m_load_mutex;
+		std::vector<std::shared_ptr<IResource>> m_resources_loading;
+
 		Scene_State m_state;
 	};
 }
\ No newline at end of file
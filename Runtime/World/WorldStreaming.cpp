@@ -0,0 +1,459 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========================
+#include "WorldStreaming.h"
+#include <cmath>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "World.h"
+#include "Entity.h"
+#include "Components/Transform.h"
+#include "Components/Renderable.h"
+#include "Components/Camera.h"
+#include "Components/Light.h"
+#include "Components/Skybox.h"
+#include "../IO/FileStream.h"
+#include "../Logging/Log.h"
+#include "../Resource/ResourceCache.h"
+#include "../Rendering/Material.h"
+#include "../Threading/Threading.h"
+//======================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Directus::Math;
+//=============================
+
+namespace Directus
+{
+	static const unsigned int g_cells_loading_max = 2; // cells loading their resources at the same time
+
+	namespace
+	{
+		// Cameras, lights and the skybox have to be around regardless of where the camera is
+		bool IsStreamable(Entity* entity)
+		{
+			if (entity->HasComponent<Camera>() || entity->HasComponent<Light>() || entity->HasComponent<Skybox>())
+				return false;
+
+			for (const auto& child : entity->GetTransform_PtrRaw()->GetChildren())
+			{
+				if (!IsStreamable(child->GetEntity_PtrRaw()))
+					return false;
+			}
+
+			return true;
+		}
+
+		void GatherResourcePaths(Entity* entity, unordered_set<string>* paths)
+		{
+			if (auto renderable = entity->GetRenderable_PtrRaw())
+			{
+				// Default geometry and materials are created in memory, they have no file
+				const auto model = renderable->GeometryModel();
+				if (model && model->HasFilePath())
+				{
+					paths->emplace(model->GetResourceFilePath());
+				}
+
+				const auto material = renderable->MaterialPtr();
+				if (material && material->HasFilePath())
+				{
+					paths->emplace(material->GetResourceFilePath());
+				}
+			}
+
+			for (const auto& child : entity->GetTransform_PtrRaw()->GetChildren())
+			{
+				GatherResourcePaths(child->GetEntity_PtrRaw(), paths);
+			}
+		}
+	}
+
+	WorldStreaming::WorldStreaming(Context* context, World* world)
+	{
+		m_context	= context;
+		m_world		= world;
+	}
+
+	void WorldStreaming::Tick(const Vector3& position)
+	{
+		if (!m_enabled || m_cells.empty())
+			return;
+
+		// Unload what's too far, and create the entities of (at most) one cell that finished loading
+		unsigned int cells_loading	= 0;
+		auto applied				= false;
+		for (const auto& cell : m_cells)
+		{
+			const auto distance = GetDistance(*cell, position);
+
+			if (cell->state == Cell_Loaded && distance > m_distance_unload)
+			{
+				Unload(cell.get());
+			}
+			else if (cell->state == Cell_Ready)
+			{
+				if (distance > m_distance_unload)
+				{
+					// Moved away while it was loading
+					cell->resources.clear();
+					cell->state = Cell_Unloaded;
+				}
+				else if (!applied)
+				{
+					Apply(cell.get());
+					applied = true;
+				}
+			}
+			else if (cell->state == Cell_Loading)
+			{
+				cells_loading++;
+			}
+		}
+
+		// Over budget, unload the furthest cells which are not needed
+		while (m_memory_usage > m_memory_budget)
+		{
+			WorldCell* furthest			= nullptr;
+			auto furthest_distance		= m_distance_load;
+			for (const auto& cell : m_cells)
+			{
+				const auto distance = GetDistance(*cell, position);
+				if (cell->state == Cell_Loaded && distance > furthest_distance)
+				{
+					furthest			= cell.get();
+					furthest_distance	= distance;
+				}
+			}
+
+			if (!furthest)
+				break;
+
+			Unload(furthest);
+		}
+
+		// Start loading the closest cells in range, while within budget
+		if (cells_loading >= g_cells_loading_max || m_memory_usage >= m_memory_budget)
+			return;
+
+		vector<pair<float, shared_ptr<WorldCell>>> candidates;
+		for (const auto& cell : m_cells)
+		{
+			const auto distance = GetDistance(*cell, position);
+			if (cell->state == Cell_Unloaded && distance <= m_distance_load)
+			{
+				candidates.emplace_back(distance, cell);
+			}
+		}
+		sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+		for (const auto& candidate : candidates)
+		{
+			if (cells_loading++ >= g_cells_loading_max)
+				break;
+
+			Load(candidate.second);
+		}
+	}
+
+	void WorldStreaming::Clear()
+	{
+		m_cells.clear();
+		m_memory_usage = 0;
+	}
+
+	void WorldStreaming::SaveCells(const string& world_file_path, const vector<shared_ptr<Entity>>& roots, vector<shared_ptr<Entity>>* roots_persistent)
+	{
+		// Find out which cell each root belongs to
+		unordered_map<WorldCell*, vector<shared_ptr<Entity>>> cell_roots;
+		for (const auto& root : roots)
+		{
+			if (!IsStreamable(root.get()))
+			{
+				roots_persistent->emplace_back(root);
+				continue;
+			}
+
+			const auto& position	= root->GetTransform_PtrRaw()->GetPosition();
+			const auto x			= static_cast<int>(floor(position.x / m_cell_size));
+			const auto z			= static_cast<int>(floor(position.z / m_cell_size));
+			auto target				= GetCell(x, z);
+			if (!target)
+			{
+				auto& cell	= m_cells.emplace_back(make_shared<WorldCell>());
+				cell->x		= x;
+				cell->z		= z;
+				cell->state	= Cell_Loaded; // nothing on disk yet, so nothing to lose
+				target		= cell.get();
+			}
+
+			// A cell can only be rewritten if it's entities are loaded, otherwise the root stays in the cell it came from
+			if (target->state != Cell_Loaded)
+			{
+				target = nullptr;
+				for (const auto& origin : m_cells)
+				{
+					if (origin->state == Cell_Loaded && find(origin->root_ids.begin(), origin->root_ids.end(), root->GetId()) != origin->root_ids.end())
+					{
+						target = origin.get();
+						break;
+					}
+				}
+			}
+
+			if (target)
+			{
+				cell_roots[target].emplace_back(root);
+			}
+			else
+			{
+				roots_persistent->emplace_back(root);
+			}
+		}
+
+		const auto directory = FileSystem::GetFilePathWithoutExtension(world_file_path) + "_cells/";
+		if (!m_cells.empty() && !FileSystem::DirectoryExists(directory))
+		{
+			FileSystem::CreateDirectory_(directory);
+		}
+
+		for (auto it = m_cells.begin(); it != m_cells.end();)
+		{
+			auto cell				= it->get();
+			const auto file_path	= directory + to_string(cell->x) + "_" + to_string(cell->z) + EXTENSION_WORLD_CELL;
+
+			// Not loaded, the file on disk is still valid (but might have to follow the world)
+			if (cell->state != Cell_Loaded)
+			{
+				if (cell->file_path != file_path)
+				{
+					FileSystem::CopyFileFromTo(cell->file_path, file_path);
+					cell->file_path = file_path;
+				}
+				++it;
+				continue;
+			}
+
+			// Loaded, but everything in it was removed or moved away
+			const auto& entities = cell_roots[cell];
+			if (entities.empty())
+			{
+				if (cell->file_path == file_path)
+				{
+					FileSystem::DeleteFile_(file_path);
+				}
+				m_memory_usage -= min(m_memory_usage, cell->memory_usage);
+				it = m_cells.erase(it);
+				continue;
+			}
+
+			auto file = make_unique<FileStream>(file_path, FileStreamMode_Write);
+			if (!file->IsOpen())
+			{
+				LOG_ERROR("Failed to save cell \"" + file_path + "\"");
+				++it;
+				continue;
+			}
+
+			// 1st - the resources the cell references
+			file->Write(GetResourcePaths(entities));
+
+			// 2nd - the entities
+			m_world->EntitiesSerialize(file.get(), entities);
+
+			cell->file_path = file_path;
+			cell->root_ids.clear();
+			for (const auto& root : entities)
+			{
+				cell->root_ids.emplace_back(root->GetId());
+			}
+
+			++it;
+		}
+	}
+
+	void WorldStreaming::SaveTable(FileStream* file) const
+	{
+		file->Write(m_enabled ? static_cast<unsigned int>(m_cells.size()) : 0);
+		if (!m_enabled || m_cells.empty())
+			return;
+
+		file->Write(m_cell_size);
+		for (const auto& cell : m_cells)
+		{
+			file->Write(cell->x);
+			file->Write(cell->z);
+			file->Write(cell->file_path);
+		}
+	}
+
+	void WorldStreaming::LoadTable(FileStream* file)
+	{
+		Clear();
+
+		// Worlds saved before streaming existed end before the table
+		unsigned int cell_count = 0;
+		file->Read(&cell_count);
+		if (cell_count == 0)
+			return;
+
+		m_enabled = true;
+		file->Read(&m_cell_size);
+		for (unsigned int i = 0; i < cell_count; i++)
+		{
+			auto cell = make_shared<WorldCell>();
+			file->Read(&cell->x);
+			file->Read(&cell->z);
+			file->Read(&cell->file_path);
+			m_cells.emplace_back(cell);
+		}
+	}
+
+	vector<string> WorldStreaming::GetResourcePaths(const vector<shared_ptr<Entity>>& roots)
+	{
+		unordered_set<string> paths;
+		for (const auto& root : roots)
+		{
+			GatherResourcePaths(root.get(), &paths);
+		}
+
+		return vector<string>(paths.begin(), paths.end());
+	}
+
+	float WorldStreaming::GetDistance(const WorldCell& cell, const Vector3& position) const
+	{
+		// Distance to the cell's square, on the XZ plane
+		const auto min_x	= cell.x * m_cell_size;
+		const auto min_z	= cell.z * m_cell_size;
+		const auto dx		= Helper::Max(Helper::Max(min_x - position.x, 0.0f), position.x - (min_x + m_cell_size));
+		const auto dz		= Helper::Max(Helper::Max(min_z - position.z, 0.0f), position.z - (min_z + m_cell_size));
+
+		return sqrt(dx * dx + dz * dz);
+	}
+
+	WorldCell* WorldStreaming::GetCell(const int x, const int z) const
+	{
+		for (const auto& cell : m_cells)
+		{
+			if (cell->x == x && cell->z == z)
+				return cell.get();
+		}
+
+		return nullptr;
+	}
+
+	void WorldStreaming::Load(const shared_ptr<WorldCell>& cell)
+	{
+		cell->state = Cell_Loading;
+
+		// The worker holds on to the cell, so it doesn't matter if the cell is dropped in the meantime.
+		// The path is copied, saving the cells can change it while the worker runs.
+		auto resource_cache = m_context->GetSubsystem<ResourceCache>().get();
+		m_context->GetSubsystem<Threading>()->AddTask([cell, file_path = cell->file_path, resource_cache]()
+		{
+			vector<string> resource_paths;
+			{
+				auto file = make_unique<FileStream>(file_path, FileStreamMode_Read);
+				if (file->IsOpen())
+				{
+					file->Read(&resource_paths);
+				}
+			}
+
+			unsigned int memory_usage = 0;
+			vector<shared_ptr<IResource>> resources;
+			for (const auto& resource_path : resource_paths)
+			{
+				shared_ptr<IResource> resource;
+				if (FileSystem::IsEngineModelFile(resource_path))
+				{
+					resource = resource_cache->Load<Model>(resource_path);
+				}
+				else if (FileSystem::IsEngineMaterialFile(resource_path))
+				{
+					resource = resource_cache->Load<Material>(resource_path);
+				}
+				else if (FileSystem::IsEngineTextureFile(resource_path))
+				{
+					resource = resource_cache->Load<RHI_Texture>(resource_path);
+				}
+
+				if (resource)
+				{
+					memory_usage += resource->GetMemoryUsage();
+					resources.emplace_back(move(resource));
+				}
+			}
+
+			cell->memory_usage	= memory_usage;
+			cell->resources		= move(resources);
+			cell->state			= Cell_Ready;
+		});
+	}
+
+	void WorldStreaming::Apply(WorldCell* cell)
+	{
+		// Released on return, by then the entities reference what they need
+		const auto resources = move(cell->resources);
+
+		cell->state = Cell_Loaded;
+		cell->root_ids.clear();
+		m_memory_usage += cell->memory_usage;
+
+		auto file = make_unique<FileStream>(cell->file_path, FileStreamMode_Read);
+		if (!file->IsOpen())
+		{
+			LOG_ERROR("Failed to load cell \"" + cell->file_path + "\"");
+			return;
+		}
+
+		// The resources are already in the cache
+		vector<string> resource_paths;
+		file->Read(&resource_paths);
+
+		vector<shared_ptr<Entity>> roots;
+		m_world->EntitiesDeserialize(file.get(), &roots);
+		for (const auto& root : roots)
+		{
+			cell->root_ids.emplace_back(root->GetId());
+		}
+	}
+
+	void WorldStreaming::Unload(WorldCell* cell)
+	{
+		World::BatchScope batch(m_world);
+		for (const auto id : cell->root_ids)
+		{
+			// Might have been removed by hand
+			if (auto entity = m_world->EntityGetById(id))
+			{
+				m_world->EntityRemove(entity);
+			}
+		}
+
+		cell->root_ids.clear();
+		cell->state		= Cell_Unloaded;
+		m_memory_usage	-= min(m_memory_usage, cell->memory_usage);
+	}
+}
@@ -0,0 +1,118 @@
+/*
+Copyright(c) 2016-2019 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==================
+#include <vector>
+#include <memory>
+#include <string>
+#include <atomic>
+#include "../Core/EngineDefs.h"
+#include "../Math/Vector3.h"
+//=============================
+
+namespace Directus
+{
+	class Context;
+	class Entity;
+	class World;
+	class FileStream;
+	class IResource;
+
+	enum Cell_State
+	{
+		Cell_Unloaded,
+		Cell_Loading,	// resources are being loaded by a worker thread
+		Cell_Ready,		// resources are loaded, the entities can be created
+		Cell_Loaded
+	};
+
+	// A square area of the world (on the XZ plane), saved in it's own file
+	struct WorldCell
+	{
+		int x = 0;
+		int z = 0;
+		std::string file_path;
+		std::atomic<Cell_State> state = Cell_Unloaded;
+		std::vector<unsigned int> root_ids;	// the root entities the cell created
+		unsigned int memory_usage = 0;		// estimated from the resources it references
+		std::vector<std::shared_ptr<IResource>> resources; // held from loading until applied, so they can't be evicted in between
+	};
+
+	// Streams the cells of a world in and out based on their distance from a position (the camera).
+	// Root entities without a camera, light or skybox in their hierarchy are saved into cells, anything else
+	// is saved into the world file and is always loaded.
+	class ENGINE_CLASS WorldStreaming
+	{
+	public:
+		WorldStreaming(Context* context, World* world);
+		~WorldStreaming() = default;
+
+		void Tick(const Math::Vector3& position);
+		// Forgets all cells (cells which are still loading finish on their own)
+		void Clear();
+
+		//= IO ==============================================================================================================================
+		// Saves the streamable roots into cell files and returns the rest, which should go into the world file
+		void SaveCells(const std::string& world_file_path, const std::vector<std::shared_ptr<Entity>>& roots, std::vector<std::shared_ptr<Entity>>* roots_persistent);
+		void SaveTable(FileStream* file) const;
+		void LoadTable(FileStream* file);
+		// The model and material files the given roots (and their descendants) reference
+		static std::vector<std::string> GetResourcePaths(const std::vector<std::shared_ptr<Entity>>& roots);
+		//===================================================================================================================================
+
+		//= PROPERTIES ========================================================================================
+		bool IsEnabled() const							{ return m_enabled; }
+		void SetEnabled(bool enabled)					{ m_enabled = enabled; }
+		float GetCellSize() const						{ return m_cell_size; }
+		void SetCellSize(float size)					{ m_cell_size = size; }
+		// Cells closer than this get loaded
+		float GetLoadDistance() const					{ return m_distance_load; }
+		void SetLoadDistance(float distance)			{ m_distance_load = distance; }
+		// Cells further than this get unloaded (larger than the load distance, so cells on the edge don't flicker)
+		float GetUnloadDistance() const					{ return m_distance_unload; }
+		void SetUnloadDistance(float distance)			{ m_distance_unload = distance; }
+		// Cells stop loading once the cells already loaded are estimated to use this much memory
+		unsigned int GetMemoryBudget() const			{ return m_memory_budget; }
+		void SetMemoryBudget(unsigned int bytes)		{ m_memory_budget = bytes; }
+		unsigned int GetMemoryUsage() const				{ return m_memory_usage; }
+		unsigned int GetCellCount() const				{ return static_cast<unsigned int>(m_cells.size()); }
+		//=====================================================================================================
+
+	private:
+		float GetDistance(const WorldCell& cell, const Math::Vector3& position) const;
+		WorldCell* GetCell(int x, int z) const;
+		void Load(const std::shared_ptr<WorldCell>& cell);
+		void Apply(WorldCell* cell);
+		void Unload(WorldCell* cell);
+
+		std::vector<std::shared_ptr<WorldCell>> m_cells;
+		bool m_enabled					= false;
+		float m_cell_size				= 128.0f;
+		float m_distance_load			= 256.0f;
+		float m_distance_unload			= 384.0f;
+		unsigned int m_memory_budget	= 512 * 1024 * 1024;
+		unsigned int m_memory_usage		= 0;
+		Context* m_context;
+		World* m_world;
+	};
+}